@@ -0,0 +1,217 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "minimax_algorithm.h"
+#include "bitboard.h"
+#include "evaluator.h"
+#include "candidate_set.h"
+#include "line_kernel.h"
+
+/**
+ * Engine microbenchmarks over a fixed corpus of opening, middle and late
+ * game positions (benchmarks/positions.txt): check_win for both sides,
+ * evaluator_reset (a LineEvaluator scoring the position from scratch),
+ * cal_score (the reference scan_side_score), candidate_scores (the
+ * candidate cells with the threat score of each) and get_next_move at
+ * depths 1 to 5. The first ones time the building blocks in isolation:
+ * inside the search, evaluation is incremental and the moves are also
+ * ordered by the table, killer and history moves, which only the
+ * get_next_move benchmarks include.
+ *
+ * Each benchmark repeats until it has run for the minimum time. Results
+ * are printed as a table, as CSV, or as JSON in the layout of Google
+ * Benchmark's output, so two builds can be compared by script; the
+ * checksum column must match between builds that search alike.
+ *
+ * Usage: gobang_bench [--corpus=FILE] [--format=text|csv|json] [--min-time=SECONDS] [--max-depth=N]
+ */
+#ifndef GOBANG_BENCH_CORPUS
+#define GOBANG_BENCH_CORPUS "benchmarks/positions.txt"
+#endif
+
+struct Position {
+    std::string name;
+    int size;
+    std::vector<std::pair<int, int>> player_pieces;
+    std::vector<std::pair<int, int>> opponent_pieces;
+};
+
+struct Result {
+    std::string name;
+    long long iterations;
+    double ns_per_op;
+    long long nodes;        // search_count per call, -1 where it does not apply
+    long long checksum;
+};
+
+static bool load_corpus(const std::string& path, std::vector<Position>& positions)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::stringstream fields(line);
+        Position pos;
+        fields >> pos.name >> pos.size;
+        auto* pieces = &pos.player_pieces;
+        std::string cell;
+        while (fields >> cell) {
+            if (cell == "/") {
+                pieces = &pos.opponent_pieces;
+                continue;
+            }
+            size_t comma = cell.find(',');
+            if (comma == std::string::npos)
+                return false;
+            pieces->push_back({atoi(cell.c_str()), atoi(cell.c_str() + comma + 1)});
+        }
+        positions.push_back(pos);
+    }
+    return !positions.empty();
+}
+
+// Run `body` (one operation, returning a checksum that is the same every
+// time) for at least min_time seconds, growing the iteration count from 1
+template <typename F>
+static Result measure(const std::string& name, double min_time, F body)
+{
+    long long iterations = 1;
+    while (true) {
+        long long checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; i++)
+            checksum += body();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds >= min_time || iterations >= (1LL << 30))
+            return {name, iterations, seconds * 1e9 / iterations, -1, checksum / iterations};
+        long long target = seconds > 0 ? static_cast<long long>(iterations * min_time * 1.2 / seconds) + 1
+                                       : iterations * 100;
+        iterations = std::min(std::max(target, iterations * 2), iterations * 100);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string corpus = GOBANG_BENCH_CORPUS;
+    std::string format = "text";
+    double min_time = 0.1;
+    int max_depth = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = arg.find('=') == std::string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (arg.compare(0, 9, "--corpus=") == 0)
+            corpus = value;
+        else if (arg.compare(0, 9, "--format=") == 0)
+            format = value;
+        else if (arg.compare(0, 11, "--min-time=") == 0)
+            min_time = atof(value.c_str());
+        else if (arg.compare(0, 12, "--max-depth=") == 0)
+            max_depth = atoi(value.c_str());
+        else
+            format = "";
+    }
+    if (format != "text" && format != "csv" && format != "json") {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--corpus=FILE] [--format=text|csv|json] [--min-time=SECONDS] [--max-depth=N]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Position> positions;
+    if (!load_corpus(corpus, positions)) {
+        std::cerr << "Cannot read the position corpus " << corpus << std::endl;
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (const auto& pos : positions) {
+        Bitboard board(pos.size, pos.size);
+        CandidateSet candidates(pos.size, pos.size, 1);
+        for (const auto& pt : pos.player_pieces) {
+            board.make(0, pt.first, pt.second);
+            candidates.add_stone(pt.first, pt.second);
+        }
+        for (const auto& pt : pos.opponent_pieces) {
+            board.make(1, pt.first, pt.second);
+            candidates.add_stone(pt.first, pt.second);
+        }
+
+        results.push_back(measure("check_win/" + pos.name, min_time, [&]() {
+            return static_cast<long long>(board.check_win(0)) + board.check_win(1);
+        }));
+
+        LineEvaluator evaluator;
+        results.push_back(measure("evaluator_reset/" + pos.name, min_time, [&]() {
+            evaluator.reset(board);
+            return static_cast<long long>(evaluator.score(0)) - evaluator.score(1);
+        }));
+
+        results.push_back(measure("cal_score/" + pos.name, min_time, [&]() {
+            return static_cast<long long>(scan_side_score(board, 0)) - scan_side_score(board, 1);
+        }));
+
+        std::vector<std::pair<int, int>> moves;
+        moves.reserve(pos.size * pos.size);
+        results.push_back(measure("candidate_scores/" + pos.name, min_time, [&]() {
+            moves.clear();
+            candidates.collect(moves);
+            long long sum = 0;
+            for (const auto& move : moves)
+                sum += threat_score(board, 0, move.first, move.second) +
+                       threat_score(board, 1, move.first, move.second);
+            return sum;
+        }));
+
+        for (int depth = 1; depth <= max_depth; depth++) {
+            MinimaxAlgorithm minimax({pos.size, pos.size}, depth, 1.0);
+            long long nodes = 0;
+            Result result = measure("get_next_move/depth:" + std::to_string(depth) + "/" + pos.name, min_time, [&]() {
+                auto move = minimax.get_next_move(pos.player_pieces, pos.opponent_pieces);
+                nodes = minimax.get_statistics()["search_count"];
+                return static_cast<long long>(move.first * pos.size + move.second);
+            });
+            result.nodes = nodes;
+            results.push_back(result);
+        }
+    }
+
+    if (format == "csv") {
+        std::cout << "name,iterations,ns_per_op,nodes,checksum" << std::endl;
+        for (const auto& r : results)
+            std::cout << r.name << "," << r.iterations << "," << std::fixed << std::setprecision(1) << r.ns_per_op
+                      << "," << r.nodes << "," << r.checksum << std::endl;
+    } else if (format == "json") {
+        std::cout << "{\n  \"context\": {\n    \"executable\": \"" << argv[0] << "\",\n    \"corpus\": \"" << corpus
+                  << "\",\n    \"line_kernel\": \"" << line_kernel_name(best_line_kernel())
+                  << "\",\n    \"min_time\": " << min_time << "\n  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const auto& r = results[i];
+            std::cout << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                      << ", \"real_time\": " << std::fixed << std::setprecision(1) << r.ns_per_op
+                      << ", \"time_unit\": \"ns\"";
+            if (r.nodes >= 0)
+                std::cout << ", \"nodes\": " << r.nodes;
+            std::cout << ", \"checksum\": " << r.checksum << "}";
+        }
+        std::cout << "\n  ]\n}" << std::endl;
+    } else {
+        std::cout << "line kernel " << line_kernel_name(best_line_kernel()) << ", " << positions.size()
+                  << " positions from " << corpus << std::endl;
+        for (const auto& r : results) {
+            std::cout << std::setw(40) << std::left << r.name << std::right << std::setw(14) << std::fixed
+                      << std::setprecision(1) << r.ns_per_op << " ns" << std::setw(12) << r.iterations << " iter";
+            if (r.nodes >= 0)
+                std::cout << std::setw(10) << r.nodes << " nodes";
+            std::cout << std::endl;
+        }
+    }
+    return 0;
+}
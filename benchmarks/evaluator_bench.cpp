@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "bitboard.h"
+#include "evaluator.h"
+
+/**
+ * Evaluator microbenchmark: times the cal_score reference scan, a full
+ * LineEvaluator reset, an incremental make/unmake update and the move
+ * ordering threat_score on random clustered positions. The checksums
+ * are the summed scores, so two builds can be compared for equality.
+ *
+ * Usage: gobang_eval_bench [positions] [size]
+ */
+template <typename F>
+static void run(const char* name, long long operations, F body)
+{
+    auto start = std::chrono::steady_clock::now();
+    long long checksum = body();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(16) << std::left << name << std::right << std::setw(10) << ns / operations
+              << " ns/op  checksum " << checksum << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int count = 200;
+    int size = 15;
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (argc > 2)
+        size = atoi(argv[2]);
+
+    // Random clustered positions of 10 to 60 stones
+    std::mt19937 rng(99);
+    std::vector<Bitboard> boards;
+    for (int i = 0; i < count; i++) {
+        Bitboard board(size, size);
+        int stones = 10 + i % 51;
+        for (int k = 0; k < stones; k++) {
+            int x, y;
+            do {
+                x = size / 2 + static_cast<int>(rng() % 9) - 4;
+                y = size / 2 + static_cast<int>(rng() % 9) - 4;
+            } while (board.occupied(x, y));
+            board.make(k % 2, x, y);
+        }
+        boards.push_back(board);
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+
+    run("cal_score scan", 2LL * count, [&]() {
+        long long sum = 0;
+        for (const auto& board : boards)
+            sum += scan_side_score(board, 0) + scan_side_score(board, 1);
+        return sum;
+    });
+
+    LineEvaluator evaluator;
+    run("evaluator reset", count, [&]() {
+        long long sum = 0;
+        for (const auto& board : boards) {
+            evaluator.reset(board);
+            sum += evaluator.score(0) + evaluator.score(1);
+        }
+        return sum;
+    });
+
+    // Place and take back a stone on every empty cell
+    long long updates = 0;
+    for (auto& board : boards)
+        for (int x = 0; x < size; x++)
+            for (int y = 0; y < size; y++)
+                updates += !board.occupied(x, y);
+    run("evaluator update", 2 * updates, [&]() {
+        long long sum = 0;
+        for (auto& board : boards) {
+            evaluator.reset(board);
+            for (int x = 0; x < size; x++)
+                for (int y = 0; y < size; y++) {
+                    if (board.occupied(x, y))
+                        continue;
+                    board.make(0, x, y);
+                    evaluator.update(board, x, y);
+                    sum += evaluator.score(0) - evaluator.score(1);
+                    board.unmake(0, x, y);
+                    evaluator.update(board, x, y);
+                }
+        }
+        return sum;
+    });
+
+    run("threat_score", 2 * updates, [&]() {
+        long long sum = 0;
+        for (const auto& board : boards)
+            for (int x = 0; x < size; x++)
+                for (int y = 0; y < size; y++)
+                    if (!board.occupied(x, y))
+                        sum += threat_score(board, 0, x, y) + threat_score(board, 1, x, y);
+        return sum;
+    });
+    return 0;
+}
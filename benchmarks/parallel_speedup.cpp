@@ -0,0 +1,58 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include "minimax_algorithm.h"
+
+/**
+ * Root-parallel speed-up benchmark: searches fixed positions at depths
+ * 3, 5 and 7 with 1, 2, ... threads and prints time and speed-up
+ * against the single-threaded run.
+ *
+ * Usage: gobang_parallel_bench [max_threads] [max_depth]
+ */
+struct Position {
+    const char* name;
+    std::vector<std::pair<int, int>> player_pieces;
+    std::vector<std::pair<int, int>> opponent_pieces;
+};
+
+int main(int argc, char* argv[])
+{
+    int max_threads = std::max(1u, std::thread::hardware_concurrency());
+    int max_depth = 7;
+    if (argc > 1)
+        max_threads = atoi(argv[1]);
+    if (argc > 2)
+        max_depth = atoi(argv[2]);
+
+    std::vector<Position> positions = {
+        {"opening", {{6, 6}, {5, 7}}, {{6, 7}, {7, 6}}},
+        {"early", {{6, 6}, {5, 5}, {7, 8}, {4, 6}}, {{6, 5}, {7, 6}, {5, 7}, {6, 8}}},
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& pos : positions) {
+        for (int depth = 3; depth <= max_depth; depth += 2) {
+            double base_ms = 0;
+            for (int threads = 1; threads <= max_threads; threads *= 2) {
+                MinimaxAlgorithm minimax({12, 12}, depth, 1.0, 1 << 18, threads);
+
+                auto start = std::chrono::steady_clock::now();
+                auto move = minimax.get_next_move(pos.player_pieces, pos.opponent_pieces);
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                if (threads == 1)
+                    base_ms = ms;
+
+                auto stats = minimax.get_statistics();
+                std::cout << pos.name << " depth " << depth << " threads " << threads
+                          << ": move (" << move.first << ", " << move.second << ")"
+                          << ", " << ms << " ms, " << "search_count " << stats["search_count"]
+                          << ", speed-up " << base_ms / ms << "x" << std::endl;
+            }
+        }
+    }
+    return 0;
+}
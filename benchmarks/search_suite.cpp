@@ -0,0 +1,109 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "minimax_algorithm.h"
+
+/**
+ * Search algorithm comparison: searches a fixed suite of 12x12 positions
+ * at one depth with plain alpha-beta, principal variation search and
+ * aspiration windows, directly and by iterative deepening, and prints
+ * the nodes searched (search_count), re-searches and time of each
+ * setting, with the node change against plain alpha-beta searched the
+ * same way. Moves that differ from plain alpha-beta are listed.
+ *
+ * Usage: gobang_search_bench [depth] [aspiration_window]
+ */
+struct Position {
+    const char* name;
+    std::vector<std::pair<int, int>> player_pieces;
+    std::vector<std::pair<int, int>> opponent_pieces;
+};
+
+struct Setting {
+    const char* name;
+    SearchOptions options;
+};
+
+int main(int argc, char* argv[])
+{
+    int depth = 5;
+    int window = SearchOptions().aspiration_window;
+    if (argc > 1)
+        depth = atoi(argv[1]);
+    if (argc > 2)
+        window = atoi(argv[2]);
+
+    std::vector<Position> positions = {
+        {"opening", {{6, 6}, {5, 7}}, {{6, 7}, {7, 6}}},
+        {"early", {{6, 6}, {5, 5}, {7, 8}, {4, 6}}, {{6, 5}, {7, 6}, {5, 7}, {6, 8}}},
+        {"square", {{5, 5}, {5, 6}, {6, 7}, {7, 4}}, {{6, 6}, {4, 6}, {6, 5}, {7, 7}}},
+        {"diagonals", {{6, 6}, {7, 7}, {5, 8}, {8, 5}}, {{6, 7}, {7, 6}, {5, 7}, {8, 8}}},
+        {"middle", {{6, 6}, {4, 5}, {4, 7}, {4, 6}, {5, 7}, {3, 7}, {3, 5}, {3, 6}, {3, 8}, {7, 7}},
+         {{5, 6}, {6, 5}, {8, 4}, {4, 4}, {4, 8}, {2, 7}, {2, 4}, {3, 4}, {3, 9}, {6, 7}}},
+    };
+
+    std::vector<Setting> settings(6);
+    settings[0].name = "alpha-beta";
+    settings[1].name = "pvs";
+    settings[1].options.principal_variation_search = true;
+    settings[2].name = "id alpha-beta";
+    settings[2].options.iterative_deepening = true;
+    settings[3].name = "id pvs";
+    settings[3].options.iterative_deepening = true;
+    settings[3].options.principal_variation_search = true;
+    settings[4].name = "id aspiration";
+    settings[4].options.iterative_deepening = true;
+    settings[4].options.aspiration_windows = true;
+    settings[5].name = "id pvs+aspiration";
+    settings[5].options.iterative_deepening = true;
+    settings[5].options.principal_variation_search = true;
+    settings[5].options.aspiration_windows = true;
+    for (auto& setting : settings)
+        setting.options.aspiration_window = window;
+
+    std::cout << "depth " << depth << ", " << positions.size() << " positions, aspiration window " << window
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    // Baseline per search style: plain alpha-beta, direct or deepening
+    long long baseline_nodes[2] = {0, 0};
+    std::vector<std::pair<int, int>> baseline_moves[2];
+    for (const auto& setting : settings) {
+        int style = setting.options.iterative_deepening ? 1 : 0;
+        bool baseline = !setting.options.principal_variation_search && !setting.options.aspiration_windows;
+        long long nodes = 0, pvs_researches = 0, aspiration_researches = 0;
+        double ms = 0;
+        std::string differences;
+
+        for (size_t i = 0; i < positions.size(); i++) {
+            MinimaxAlgorithm minimax({12, 12}, depth, 1.0, 1 << 18, 1, setting.options);
+            auto start = std::chrono::steady_clock::now();
+            auto move = minimax.get_next_move(positions[i].player_pieces, positions[i].opponent_pieces);
+            ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            auto stats = minimax.get_statistics();
+            nodes += stats["search_count"];
+            pvs_researches += stats["pvs_researches"];
+            aspiration_researches += stats["aspiration_researches"];
+            if (baseline) {
+                baseline_moves[style].push_back(move);
+            } else if (move != baseline_moves[style][i]) {
+                differences += std::string(" ") + positions[i].name;
+            }
+        }
+        if (baseline)
+            baseline_nodes[style] = nodes;
+
+        std::cout << std::setw(18) << std::left << setting.name << std::right << std::setw(10) << nodes
+                  << " nodes " << std::setw(7) << 100.0 * (nodes - baseline_nodes[style]) / baseline_nodes[style]
+                  << "%  pvs re-searches " << pvs_researches << ", aspiration re-searches "
+                  << aspiration_researches << ", " << ms << " ms";
+        if (!differences.empty())
+            std::cout << ", other move in" << differences;
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "bitboard.h"
+#include <algorithm>
+
+Bitboard::Bitboard(int columns, int rows) {
+    reset(columns, rows);
+}
+
+void Bitboard::reset(int columns, int rows) {
+    column_count = columns;
+    row_count = rows;
+
+    int word_count = (columns * rows + 63) / 64;
+    planes[0].assign(word_count, 0);
+    planes[1].assign(word_count, 0);
+    stone_count[0] = 0;
+    stone_count[1] = 0;
+    use_kernel = columns <= KERNEL_MAX_SIZE && rows <= KERNEL_MAX_SIZE;
+    std::fill(&column_masks[0][0], &column_masks[0][0] + 2 * KERNEL_MAX_SIZE, 0);
+}
+
+void Bitboard::clear() {
+    std::fill(planes[0].begin(), planes[0].end(), 0);
+    std::fill(planes[1].begin(), planes[1].end(), 0);
+    stone_count[0] = 0;
+    stone_count[1] = 0;
+    std::fill(&column_masks[0][0], &column_masks[0][0] + 2 * KERNEL_MAX_SIZE, 0);
+}
+
+std::vector<std::pair<int, int>> Bitboard::pieces(int side) const {
+    std::vector<std::pair<int, int>> result;
+    result.reserve(stone_count[side]);
+
+    for (size_t w = 0; w < planes[side].size(); w++) {
+        uint64_t bits = planes[side][w];
+        while (bits) {
+            int i = static_cast<int>(w * 64) + __builtin_ctzll(bits);
+            result.push_back({i / row_count, i % row_count});
+            bits &= bits - 1;
+        }
+    }
+    return result;
+}
+
+bool Bitboard::check_win(int side) const {
+    if (use_kernel) {
+        return (find_fives(&column_masks[0][0]) >> side) & 1;
+    }
+    return check_win_scan(side);
+}
+
+int Bitboard::fives() const {
+    if (use_kernel) {
+        return find_fives(&column_masks[0][0]);
+    }
+    return (check_win_scan(0) ? 1 : 0) | (check_win_scan(1) ? 2 : 0);
+}
+
+bool Bitboard::check_win_scan(int side) const {
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    for (int m = 0; m < column_count; m++) {
+        for (int n = 0; n < row_count; n++) {
+            if (!has(side, m, n)) {
+                continue;
+            }
+            for (const auto& d : directions) {
+                int k = 1;
+                while (k < 5 && has(side, m + k * d[0], n + k * d[1])) {
+                    k++;
+                }
+                if (k == 5) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool Bitboard::check_win_at(int side, int x, int y) const {
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    for (const auto& d : directions) {
+        int count = 1;
+        for (int k = 1; k < 5 && has(side, x + k * d[0], y + k * d[1]); k++) {
+            count++;
+        }
+        for (int k = 1; k < 5 && has(side, x - k * d[0], y - k * d[1]); k++) {
+            count++;
+        }
+        if (count >= 5) {
+            return true;
+        }
+    }
+    return false;
+}
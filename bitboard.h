@@ -0,0 +1,98 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "line_kernel.h"
+
+// Packed board position: one bit plane per side, sized from the board
+// dimensions. Cell (x, y) is stored at bit x * rows + y. Cells outside the
+// board read as empty, which is what the pattern scoring expects.
+// Boards of up to 16x16 also keep one 16-bit mask per column and side
+// for the SIMD five-in-a-row kernel (line_kernel.h).
+class Bitboard {
+public:
+    // Constructor
+    Bitboard(int columns = 12, int rows = 12);
+
+    // Resize the board and remove every stone
+    void reset(int columns, int rows);
+    void clear();
+
+    int columns() const { return column_count; }
+    int rows() const { return row_count; }
+
+    bool in_bounds(int x, int y) const {
+        return x >= 0 && x < column_count && y >= 0 && y < row_count;
+    }
+
+    int index(int x, int y) const { return x * row_count + y; }
+
+    // True if `side` (0 or 1) has a stone on (x, y); false when off the board
+    bool has(int side, int x, int y) const {
+        if (!in_bounds(x, y)) {
+            return false;
+        }
+        int i = index(x, y);
+        return (planes[side][i >> 6] >> (i & 63)) & 1;
+    }
+
+    // Same for a cell index known to be on the board, without the bounds check
+    bool has_cell(int side, int i) const {
+        return (planes[side][i >> 6] >> (i & 63)) & 1;
+    }
+
+    bool occupied(int x, int y) const {
+        return has(0, x, y) || has(1, x, y);
+    }
+
+    // Place / remove a stone, O(1)
+    void make(int side, int x, int y) {
+        int i = index(x, y);
+        planes[side][i >> 6] |= uint64_t(1) << (i & 63);
+        stone_count[side]++;
+        if (use_kernel) {
+            column_masks[side][x] |= static_cast<uint16_t>(1u << y);
+        }
+    }
+
+    void unmake(int side, int x, int y) {
+        int i = index(x, y);
+        planes[side][i >> 6] &= ~(uint64_t(1) << (i & 63));
+        stone_count[side]--;
+        if (use_kernel) {
+            column_masks[side][x] &= static_cast<uint16_t>(~(1u << y));
+        }
+    }
+
+    int count(int side) const { return stone_count[side]; }
+
+    // Stones of `side` in cell index order
+    std::vector<std::pair<int, int>> pieces(int side) const;
+
+    // Full-board five-in-a-row test for `side`
+    bool check_win(int side) const;
+
+    // Bit `side` set for each side with five in a row, both sides in one
+    // pass of the SIMD kernel where the board fits it
+    int fives() const;
+
+    // check_win() as a cell-by-cell scan; the reference for the kernels
+    bool check_win_scan(int side) const;
+
+    // Five-in-a-row for `side` on one of the four lines through (x, y).
+    // A five can only be made by the stone just placed, so this is the
+    // terminal test used inside the search.
+    bool check_win_at(int side, int x, int y) const;
+
+private:
+    int column_count;
+    int row_count;
+    int stone_count[2];
+    std::vector<uint64_t> planes[2];
+    bool use_kernel;
+    uint16_t column_masks[2][KERNEL_MAX_SIZE];
+};
+
+#endif // BITBOARD_H
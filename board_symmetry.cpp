@@ -0,0 +1,61 @@
+#include "board_symmetry.h"
+
+int symmetry_count(int columns, int rows) {
+    return columns == rows ? 8 : 4;
+}
+
+std::pair<int, int> apply_symmetry(int symmetry, int x, int y, int columns, int rows) {
+    if (symmetry & 4) {
+        std::swap(x, y);
+    }
+    if (symmetry & 1) {
+        x = columns - 1 - x;
+    }
+    if (symmetry & 2) {
+        y = rows - 1 - y;
+    }
+    return {x, y};
+}
+
+void SymmetricKeys::reset(int columns, int rows) {
+    cells = columns * rows;
+    symmetries = symmetry_count(columns, rows);
+    cell_map.resize(symmetries * cells);
+    for (int s = 0; s < symmetries; s++) {
+        for (int x = 0; x < columns; x++) {
+            for (int y = 0; y < rows; y++) {
+                auto mapped = apply_symmetry(s, x, y, columns, rows);
+                cell_map[s * cells + x * rows + y] = mapped.first * rows + mapped.second;
+            }
+        }
+    }
+    clear();
+}
+
+void SymmetricKeys::clear() {
+    for (auto& key : key_of) {
+        key = 0;
+    }
+}
+
+uint64_t canonical_key(const Bitboard& board, const ZobristKeys& keys, int& symmetry) {
+    int columns = board.columns();
+    int rows = board.rows();
+    uint64_t best = 0;
+    symmetry = 0;
+
+    for (int s = 0; s < symmetry_count(columns, rows); s++) {
+        uint64_t key = 0;
+        for (int side = 0; side < 2; side++) {
+            for (const auto& pt : board.pieces(side)) {
+                auto mapped = apply_symmetry(s, pt.first, pt.second, columns, rows);
+                key ^= keys.stone(side, board.index(mapped.first, mapped.second));
+            }
+        }
+        if (s == 0 || key < best) {
+            best = key;
+            symmetry = s;
+        }
+    }
+    return best;
+}
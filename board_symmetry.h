@@ -0,0 +1,74 @@
+#ifndef BOARD_SYMMETRY_H
+#define BOARD_SYMMETRY_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "bitboard.h"
+#include "transposition_table.h"
+
+// Board symmetries, numbered by three bits: 4 transposes (x, y) -> (y, x),
+// then 1 mirrors x and 2 mirrors y. A square board has all eight; a
+// rectangular one only the four without the transpose.
+int symmetry_count(int columns, int rows);
+
+// Where (x, y) goes under `symmetry`
+std::pair<int, int> apply_symmetry(int symmetry, int x, int y, int columns, int rows);
+
+// The symmetry that undoes `symmetry`
+inline int inverse_symmetry(int symmetry) {
+    // Flipping after a transpose is undone by the transpose after the
+    // other flip, so the two flip bits swap
+    return (symmetry & 4) ? (4 | (symmetry & 1) << 1 | (symmetry & 2) >> 1) : symmetry;
+}
+
+// The Zobrist key of the board under each of its symmetries, kept up to
+// date stone by stone, so the canonical (smallest) key of a position is
+// available in O(1) for the opening book, and the transposition table can
+// look up the moves stored for the rotations and reflections of a position.
+class SymmetricKeys {
+public:
+    // Build the cell maps for the board size and clear the keys
+    void reset(int columns, int rows);
+    void clear();
+
+    int count() const { return symmetries; }
+
+    // Call when a stone of `side` is placed on or removed from `cell`
+    void toggle(const ZobristKeys& keys, int side, int cell) {
+        for (int s = 0; s < symmetries; s++) {
+            key_of[s] ^= keys.stone(side, cell_map[s * cells + cell]);
+        }
+    }
+
+    // Key of the board as seen through `symmetry`; key(0) is the plain key
+    uint64_t key(int symmetry) const { return key_of[symmetry]; }
+
+    // Smallest of the keys, and the symmetry that gives it
+    uint64_t canonical(int& symmetry) const {
+        symmetry = 0;
+        for (int s = 1; s < symmetries; s++) {
+            if (key_of[s] < key_of[symmetry]) {
+                symmetry = s;
+            }
+        }
+        return key_of[symmetry];
+    }
+
+    // Cell index that `cell` maps to under `symmetry`
+    int map_cell(int symmetry, int cell) const { return cell_map[symmetry * cells + cell]; }
+
+private:
+    int cells;
+    int symmetries;
+    uint64_t key_of[8];
+    std::vector<int> cell_map;      // symmetry * cells + cell -> mapped cell
+};
+
+// Smallest Zobrist key of `board` over its symmetries, side 0 being the
+// side to move. `symmetry` receives the one that gives it; a move m on
+// the board is apply_symmetry(symmetry, m) in the canonical orientation.
+// A full recomputation, for tools; SymmetricKeys gives the same key.
+uint64_t canonical_key(const Bitboard& board, const ZobristKeys& keys, int& symmetry);
+
+#endif // BOARD_SYMMETRY_H
@@ -0,0 +1,79 @@
+#include "candidate_set.h"
+#include <algorithm>
+
+CandidateSet::CandidateSet(int columns, int rows, int radius) {
+    reset(columns, rows, radius);
+}
+
+void CandidateSet::reset(int columns, int rows, int radius) {
+    column_count = columns;
+    row_count = rows;
+    near_radius = radius;
+    candidate_count = 0;
+    near_count.assign(columns * rows, 0);
+    occupied.assign(columns * rows, 0);
+    bits.assign((columns * rows + 63) / 64, 0);
+}
+
+void CandidateSet::set_bit(int i, bool on) {
+    uint64_t mask = uint64_t(1) << (i & 63);
+    bool was = (bits[i >> 6] & mask) != 0;
+    if (on && !was) {
+        bits[i >> 6] |= mask;
+        candidate_count++;
+    } else if (!on && was) {
+        bits[i >> 6] &= ~mask;
+        candidate_count--;
+    }
+}
+
+void CandidateSet::add_stone(int x, int y) {
+    int center = x * row_count + y;
+    occupied[center] = 1;
+    set_bit(center, false);
+
+    int x0 = std::max(x - near_radius, 0), x1 = std::min(x + near_radius, column_count - 1);
+    int y0 = std::max(y - near_radius, 0), y1 = std::min(y + near_radius, row_count - 1);
+    for (int i = x0; i <= x1; i++) {
+        for (int j = y0; j <= y1; j++) {
+            int cell = i * row_count + j;
+            if (cell == center) {
+                continue;
+            }
+            if (near_count[cell]++ == 0 && !occupied[cell]) {
+                set_bit(cell, true);
+            }
+        }
+    }
+}
+
+void CandidateSet::remove_stone(int x, int y) {
+    int center = x * row_count + y;
+    occupied[center] = 0;
+    set_bit(center, near_count[center] > 0);
+
+    int x0 = std::max(x - near_radius, 0), x1 = std::min(x + near_radius, column_count - 1);
+    int y0 = std::max(y - near_radius, 0), y1 = std::min(y + near_radius, row_count - 1);
+    for (int i = x0; i <= x1; i++) {
+        for (int j = y0; j <= y1; j++) {
+            int cell = i * row_count + j;
+            if (cell == center) {
+                continue;
+            }
+            if (--near_count[cell] == 0) {
+                set_bit(cell, false);
+            }
+        }
+    }
+}
+
+void CandidateSet::collect(std::vector<std::pair<int, int>>& moves) const {
+    for (size_t w = 0; w < bits.size(); w++) {
+        uint64_t word = bits[w];
+        while (word) {
+            int i = static_cast<int>(w * 64) + __builtin_ctzll(word);
+            moves.push_back({i / row_count, i % row_count});
+            word &= word - 1;
+        }
+    }
+}
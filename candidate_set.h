@@ -0,0 +1,50 @@
+#ifndef CANDIDATE_SET_H
+#define CANDIDATE_SET_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Incrementally maintained move candidates: the empty cells within
+// `radius` (Chebyshev distance) of at least one stone. Every cell keeps a
+// count of stones around it, so placing or removing a stone touches only
+// its (2 * radius + 1)^2 neighbourhood.
+class CandidateSet {
+public:
+    CandidateSet(int columns = 12, int rows = 12, int radius = 1);
+
+    // Resize and forget every stone
+    void reset(int columns, int rows, int radius);
+
+    int radius() const { return near_radius; }
+
+    // Call when a stone is placed on / removed from (x, y)
+    void add_stone(int x, int y);
+    void remove_stone(int x, int y);
+
+    bool contains(int x, int y) const {
+        int i = x * row_count + y;
+        return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    int size() const { return candidate_count; }
+
+    // Board cells, an upper bound on size()
+    int cell_count() const { return column_count * row_count; }
+
+    // Append the candidates to `moves` in cell index order
+    void collect(std::vector<std::pair<int, int>>& moves) const;
+
+private:
+    int column_count;
+    int row_count;
+    int near_radius;
+    int candidate_count;
+    std::vector<int> near_count;    // stones within radius, per cell
+    std::vector<uint8_t> occupied;
+    std::vector<uint64_t> bits;     // candidate cells
+
+    void set_bit(int i, bool on);
+};
+
+#endif // CANDIDATE_SET_H
@@ -0,0 +1,333 @@
+#include "evaluator.h"
+#include <algorithm>
+
+const std::vector<std::pair<int, std::vector<int>>>& shape_score_table() {
+    static const std::vector<std::pair<int, std::vector<int>>> shape_score = {
+        {50, {0, 1, 1, 0, 0}},
+        {50, {0, 0, 1, 1, 0}},
+        {200, {1, 1, 0, 1, 0}},
+        {500, {0, 0, 1, 1, 1}},
+        {500, {1, 1, 1, 0, 0}},
+        {5000, {0, 1, 1, 1, 0}},
+        {5000, {0, 1, 0, 1, 1, 0}},
+        {5000, {0, 1, 1, 0, 1, 0}},
+        {5000, {1, 1, 1, 0, 1}},
+        {5000, {1, 1, 0, 1, 1}},
+        {5000, {1, 0, 1, 1, 1}},
+        {5000, {1, 1, 1, 1, 0}},
+        {5000, {0, 1, 1, 1, 1}},
+        {50000, {0, 1, 1, 1, 1, 0}},
+        {99999999, {1, 1, 1, 1, 1}}
+    };
+    return shape_score;
+}
+
+// Shape score of every 6-cell window, indexed by its base-3 code with the
+// first cell as the most significant digit. Built once from
+// shape_score_table(): 5-long shapes match the first five cells, 6-long
+// shapes all six, and the best matching score wins.
+static std::vector<int> build_window_table() {
+    std::vector<int> table(WINDOW_CODES, 0);
+    for (int code = 0; code < WINDOW_CODES; code++) {
+        int cells[6];
+        for (int i = 5, rest = code; i >= 0; i--, rest /= 3) {
+            cells[i] = rest % 3;
+        }
+        for (const auto& shape_pair : shape_score_table()) {
+            const auto& shape = shape_pair.second;
+            if (shape_pair.first > table[code] && std::equal(shape.begin(), shape.end(), cells)) {
+                table[code] = shape_pair.first;
+            }
+        }
+    }
+    return table;
+}
+
+static const std::vector<int>& window_table() {
+    static const std::vector<int> table = build_window_table();
+    return table;
+}
+
+int window_code(const int* cells) {
+    return ((((cells[0] * 3 + cells[1]) * 3 + cells[2]) * 3 + cells[3]) * 3 + cells[4]) * 3 + cells[5];
+}
+
+int window_score(const int* cells) {
+    return window_table()[window_code(cells)];
+}
+
+int window_code_score(int code) {
+    return window_table()[code];
+}
+
+int cal_score(
+    const Bitboard& board, int m, int n, int x_direct, int y_direct, int my_side,
+    ScoreRecord& score_all_arr
+) {
+    int add_score = 0;
+    std::pair<int, std::vector<std::pair<int, int>>> max_score_shape = {0, {}};
+    std::pair<int, int> direction = {x_direct, y_direct};
+    int enemy_side = 1 - my_side;
+
+    // Check if this direction has been calculated
+    for (const auto& item : score_all_arr) {
+        for (const auto& pt : std::get<1>(item)) {
+            if (m == pt.first && n == pt.second &&
+                x_direct == std::get<2>(item).first &&
+                y_direct == std::get<2>(item).second) {
+                return 0;
+            }
+        }
+    }
+
+    // Scan in a specific direction to find shapes
+    for (int offset = -5; offset < 1; offset++) {
+        int pos[6];
+
+        for (int i = 0; i < 6; i++) {
+            std::pair<int, int> point = {m + (i + offset) * x_direct, n + (i + offset) * y_direct};
+
+            if (board.has(enemy_side, point.first, point.second)) {
+                pos[i] = 2;
+            } else if (board.has(my_side, point.first, point.second)) {
+                pos[i] = 1;
+            } else {
+                pos[i] = 0;
+            }
+        }
+
+        // Best shape of the window, from the precomputed table
+        int score = window_score(pos);
+        if (score > max_score_shape.first) {
+            std::vector<std::pair<int, int>> shape_positions;
+            for (int i = 0; i < 5; i++) {
+                shape_positions.push_back({m + (i + offset) * x_direct, n + (i + offset) * y_direct});
+            }
+            max_score_shape = {score, shape_positions};
+        }
+    }
+
+    // Calculate cross-score for shapes
+    if (!max_score_shape.second.empty()) {
+        for (const auto& item : score_all_arr) {
+            for (const auto& pt1 : std::get<1>(item)) {
+                for (const auto& pt2 : max_score_shape.second) {
+                    if (pt1 == pt2 && max_score_shape.first > 10 && std::get<0>(item) > 10) {
+                        add_score += std::get<0>(item) + max_score_shape.first;
+                    }
+                }
+            }
+        }
+
+        score_all_arr.push_back({max_score_shape.first, max_score_shape.second, direction});
+    }
+
+    return add_score + max_score_shape.first;
+}
+
+int scan_side_score(const Bitboard& board, int side) {
+    ScoreRecord score_all_arr;
+    int score = 0;
+
+    for (const auto& pt : board.pieces(side)) {
+        int m = pt.first;
+        int n = pt.second;
+        score += cal_score(board, m, n, 0, 1, side, score_all_arr);
+        score += cal_score(board, m, n, 1, 0, side, score_all_arr);
+        score += cal_score(board, m, n, 1, 1, side, score_all_arr);
+        score += cal_score(board, m, n, -1, 1, side, score_all_arr);
+    }
+    return score;
+}
+
+int centred_window_score(const int* cells) {
+    int best = 0;
+    for (int start = -4; start <= 0; start++) {
+        best = std::max(best, window_score(cells + start + 5));
+    }
+    return best;
+}
+
+int threat_score(const Bitboard& board, int side, int x, int y) {
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    int enemy_side = 1 - side;
+    int total = 0;
+
+    for (const auto& d : directions) {
+        // Cells -5..5 along the direction, with our stone on (x, y)
+        int cells[11];
+        for (int k = -5; k <= 5; k++) {
+            int cx = x + k * d[0];
+            int cy = y + k * d[1];
+            if (k == 0 || board.has(side, cx, cy)) {
+                cells[k + 5] = 1;
+            } else if (board.has(enemy_side, cx, cy)) {
+                cells[k + 5] = 2;
+            } else {
+                cells[k + 5] = 0;
+            }
+        }
+
+        total += centred_window_score(cells);
+    }
+    return total;
+}
+
+void LineEvaluator::reset(const Bitboard& board) {
+    columns = board.columns();
+    rows = board.rows();
+    padded_rows = rows + 10;
+    line_code.assign(std::max(columns, rows) + 10, 0);
+    line_window.assign(std::max(columns, rows) + 5, 0);
+
+    // Directions in cal_score order: (0, 1), (1, 0), (1, 1), (-1, 1)
+    lines.clear();
+    for (int d = 0; d < 4; d++) {
+        line_of[d].assign(columns * rows, -1);
+    }
+    for (int x = 0; x < columns; x++) {
+        lines.push_back({x, 0, 0, 1, rows, false});
+    }
+    for (int y = 0; y < rows; y++) {
+        lines.push_back({0, y, 1, 0, columns, false});
+    }
+    for (int c = -(rows - 1); c < columns; c++) {
+        int sx = std::max(c, 0);
+        int sy = std::max(-c, 0);
+        lines.push_back({sx, sy, 1, 1, std::min(columns - sx, rows - sy), false});
+    }
+    // Walking (-1, 1) visits cells in decreasing index order
+    for (int c = 0; c <= columns + rows - 2; c++) {
+        int sx = std::min(c, columns - 1);
+        int sy = c - sx;
+        lines.push_back({sx, sy, -1, 1, std::min(sx + 1, rows - sy), true});
+    }
+
+    int first_line[5] = {0, columns, columns + rows, 2 * columns + 2 * rows - 1,
+                         static_cast<int>(lines.size())};
+    for (int d = 0; d < 4; d++) {
+        for (int id = first_line[d]; id < first_line[d + 1]; id++) {
+            const Line& line = lines[id];
+            for (int t = 0; t < line.length; t++) {
+                line_of[d][board.index(line.x + t * line.dx, line.y + t * line.dy)] = id;
+            }
+        }
+    }
+
+    for (int side = 0; side < 2; side++) {
+        shapes[side].assign(lines.size(), std::vector<Shape>());
+        for (size_t id = 0; id < lines.size(); id++) {
+            shapes[side][id].reserve(lines[id].length);
+        }
+        cover_count[side].assign((columns + 10) * padded_rows, 0);
+        cover_score[side].assign((columns + 10) * padded_rows, 0);
+        shape_sum[side] = 0;
+        cross_sum[side] = 0;
+
+        for (size_t id = 0; id < lines.size(); id++) {
+            scan_line(board, side, static_cast<int>(id));
+        }
+    }
+}
+
+void LineEvaluator::update(const Bitboard& board, int x, int y) {
+    int cell = board.index(x, y);
+    for (int d = 0; d < 4; d++) {
+        int id = line_of[d][cell];
+        for (int side = 0; side < 2; side++) {
+            clear_line(side, id);
+            scan_line(board, side, id);
+        }
+    }
+}
+
+void LineEvaluator::clear_line(int side, int line_id) {
+    auto& recorded = shapes[side][line_id];
+    for (const auto& shape : recorded) {
+        cover(side, lines[line_id], shape, -1);
+    }
+    recorded.clear();
+}
+
+void LineEvaluator::scan_line(const Bitboard& board, int side, int line_id) {
+    const Line& line = lines[line_id];
+    int enemy_side = 1 - side;
+
+    // Encode the line with five off-board (empty) cells on each end
+    int* code = line_code.data() + 5;
+    std::fill(code - 5, code, 0);
+    std::fill(code + line.length, code + line.length + 5, 0);
+    for (int t = 0; t < line.length; t++) {
+        int x = line.x + t * line.dx;
+        int y = line.y + t * line.dy;
+        if (board.has(enemy_side, x, y)) {
+            code[t] = 2;
+        } else if (board.has(side, x, y)) {
+            code[t] = 1;
+        } else {
+            code[t] = 0;
+        }
+    }
+
+    // Score every window starting at -5 .. length - 1, rolling its base-3
+    // code along the line: drop the leading cell, append the next one
+    const int* scores = window_table().data();
+    int* window = line_window.data() + 5;
+    int window_id = window_code(code - 5);
+    for (int t = -5; t < line.length; t++) {
+        if (t > -5) {
+            window_id = (window_id - code[t - 1] * 243) * 3 + code[t + 5];
+        }
+        window[t] = scores[window_id];
+    }
+
+    // Visit the stones in the order cal_score sees them
+    auto& recorded = shapes[side][line_id];
+    for (int k = 0; k < line.length; k++) {
+        int t = line.reverse ? line.length - 1 - k : k;
+        if (code[t] != 1) {
+            continue;
+        }
+
+        // Stones inside an already recorded shape score nothing
+        bool covered = false;
+        for (const auto& shape : recorded) {
+            if (t >= shape.start && t < shape.start + 5) {
+                covered = true;
+                break;
+            }
+        }
+        if (covered) {
+            continue;
+        }
+
+        Shape best = {0, 0};
+        for (int offset = -5; offset < 1; offset++) {
+            if (window[t + offset] > best.score) {
+                best.start = t + offset;
+                best.score = window[t + offset];
+            }
+        }
+        if (best.score > 0) {
+            recorded.push_back(best);
+            cover(side, line, best, 1);
+        }
+    }
+}
+
+void LineEvaluator::cover(int side, const Line& line, const Shape& shape, int sign) {
+    // Cross-scores: every pair of shapes sharing a cell adds both scores,
+    // i.e. sum over cells of (covering score sum) * (covering count - 1)
+    for (int k = 0; k < 5; k++) {
+        int t = shape.start + k;
+        int i = padded_index(line.x + t * line.dx, line.y + t * line.dy);
+        int& count = cover_count[side][i];
+        long long& sum = cover_score[side][i];
+
+        cross_sum[side] -= sum * (count - 1);
+        count += sign;
+        sum += sign * static_cast<long long>(shape.score);
+        cross_sum[side] += sum * (count - 1);
+    }
+    shape_sum[side] += sign * static_cast<long long>(shape.score);
+}
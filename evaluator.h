@@ -0,0 +1,100 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <vector>
+#include <utility>
+#include <tuple>
+#include "bitboard.h"
+
+// Shape scores for pattern evaluation. In a shape 1 is an own stone,
+// 2 an enemy stone and 0 an empty (or off-board) cell.
+const std::vector<std::pair<int, std::vector<int>>>& shape_score_table();
+
+// Shapes already scored by cal_score: (score, five cells, direction)
+typedef std::vector<std::tuple<int, std::vector<std::pair<int, int>>, std::pair<int, int>>> ScoreRecord;
+
+// Score the best shape through stone (m, n) in one direction, plus the
+// cross-score against shapes already in score_all_arr
+int cal_score(const Bitboard& board, int m, int n, int x_direct, int y_direct, int my_side,
+              ScoreRecord& score_all_arr);
+
+// Table-driven shape matching. A 6-cell window (cells coded as in the
+// shapes) is read as a base-3 number, first cell most significant, and its
+// best shape_score_table() score looked up in a table built once at
+// startup. 5-long shapes match the window's first five cells.
+const int WINDOW_CODES = 729;
+int window_code(const int* cells);
+int window_code_score(int code);
+int window_score(const int* cells);
+
+// Full rescan of one side's stones through cal_score. This is the
+// reference the incremental evaluator has to match exactly.
+int scan_side_score(const Bitboard& board, int side);
+
+// Cheap static estimate of a stone for `side` on the empty cell (x, y):
+// the best shape_score shape it would be part of, summed over the four
+// directions. Used to order moves, not to evaluate positions.
+int threat_score(const Bitboard& board, int side, int x, int y);
+
+// The per-direction part of threat_score: `cells` holds the 11 cells at
+// offsets -5..5 along the line (own stone in the middle), and the result
+// is the best shape among the windows whose first five cells include it
+int centred_window_score(const int* cells);
+
+// Incremental evaluator. Keeps, for every row, column and diagonal, the
+// shapes cal_score would record on it, plus per-cell coverage so that the
+// cross-scores between overlapping shapes can be summed without pairing
+// them up. After a stone is placed or removed only the four lines through
+// that cell are rescanned; score() is O(1).
+class LineEvaluator {
+public:
+    // Size the line tables for `board` and score it from scratch
+    void reset(const Bitboard& board);
+
+    // Call after board.make()/unmake() on (x, y)
+    void update(const Bitboard& board, int x, int y);
+
+    // Same value as scan_side_score(board, side)
+    int score(int side) const {
+        // The reference sums in int, so wrap the same way
+        return static_cast<int>(static_cast<unsigned int>(shape_sum[side] + cross_sum[side]));
+    }
+
+private:
+    struct Line {
+        int x, y;       // first on-board cell
+        int dx, dy;     // step along the line
+        int length;
+        bool reverse;   // stones are visited in decreasing t (cell order)
+    };
+
+    struct Shape {
+        int start;      // first of the five cells, in line coordinates
+        int score;
+    };
+
+    int columns;
+    int rows;
+    int padded_rows;
+
+    std::vector<Line> lines;
+    std::vector<int> line_of[4];            // cell index -> line id per direction
+    std::vector<std::vector<Shape>> shapes[2];
+
+    std::vector<int> line_code;             // scratch for scan_line: cells -5 .. length + 4
+    std::vector<int> line_window;           // and window scores for starts -5 .. length - 1
+
+    // Per padded cell: number of recorded shapes covering it and their score sum
+    std::vector<int> cover_count[2];
+    std::vector<long long> cover_score[2];
+
+    long long shape_sum[2];
+    long long cross_sum[2];
+
+    int padded_index(int x, int y) const { return (x + 5) * padded_rows + (y + 5); }
+    void clear_line(int side, int line_id);
+    void scan_line(const Bitboard& board, int side, int line_id);
+    void cover(int side, const Line& line, const Shape& shape, int sign);
+};
+
+#endif // EVALUATOR_H
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include <chrono>
 #include "minimax_algorithm.h"
 
 int main() {
@@ -26,5 +27,21 @@ int main() {
     std::cout << "Pruning count this search: " << stats["cut_count"] << std::endl;
     std::cout << "Total searches this time: " << stats["search_count"] << std::endl;
 
+    // Alternatively give the search a per-turn time budget: it deepens
+    // 1, 2, 3... and returns the best move of the last completed depth
+    next_move = minimax.get_next_move(player_pieces, opponent_pieces, std::chrono::milliseconds(500));
+    stats = minimax.get_statistics();
+    std::cout << "Time-budgeted move: (" << next_move.first << ", " << next_move.second << ")"
+              << ", depth reached: " << stats["depth"] << ", time: " << stats["time_ms"] << " ms" << std::endl;
+
+    // In a running game, keep a session instead: play each stone on the
+    // engine as it happens, so the board and search tables stay warm
+    minimax.new_game();
+    for (const auto& pt : player_pieces) minimax.apply_move(0, pt);
+    for (const auto& pt : opponent_pieces) minimax.apply_move(1, pt);
+    next_move = minimax.get_next_move();
+    minimax.apply_move(0, next_move);
+    std::cout << "Session move: (" << next_move.first << ", " << next_move.second << ")" << std::endl;
+
     return 0;
-} 
\ No newline at end of file
+} 
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "line_kernel.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LINE_KERNEL_HAVE_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LINE_KERNEL_HAVE_NEON 1
+#endif
+
+// Portable version: the same shifts on plain integers, one column at a time
+static int fives_scalar(const uint16_t* columns) {
+    int found = 0;
+    for (int side = 0; side < 2; side++) {
+        const uint16_t* c = columns + side * KERNEL_MAX_SIZE;
+        uint32_t any = 0;
+        for (int x = 0; x < KERNEL_MAX_SIZE; x++) {
+            uint32_t v = c[x];
+            any |= v & v >> 1 & v >> 2 & v >> 3 & v >> 4;
+            if (x + 4 < KERNEL_MAX_SIZE) {
+                uint32_t a = c[x + 1], b = c[x + 2], d = c[x + 3], e = c[x + 4];
+                any |= v & a & b & d & e;
+                any |= v & a >> 1 & b >> 2 & d >> 3 & e >> 4;
+                any |= v & a << 1 & b << 2 & d << 3 & e << 4;
+            }
+        }
+        if (any) {
+            found |= 1 << side;
+        }
+    }
+    return found;
+}
+
+#if defined(__SSE2__)
+// Columns x + K of a side held as (lo: columns 0-7, hi: columns 8-15)
+template <int K>
+static inline void shift_columns_sse2(__m128i lo, __m128i hi, __m128i& out_lo, __m128i& out_hi) {
+    out_lo = _mm_or_si128(_mm_srli_si128(lo, 2 * K), _mm_slli_si128(hi, 16 - 2 * K));
+    out_hi = _mm_srli_si128(hi, 2 * K);
+}
+
+static inline bool side_has_five_sse2(const uint16_t* c) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + 8));
+
+    __m128i lo1, hi1, lo2, hi2, lo3, hi3, lo4, hi4;
+    shift_columns_sse2<1>(lo, hi, lo1, hi1);
+    shift_columns_sse2<2>(lo, hi, lo2, hi2);
+    shift_columns_sse2<3>(lo, hi, lo3, hi3);
+    shift_columns_sse2<4>(lo, hi, lo4, hi4);
+
+    __m128i any = _mm_setzero_si128();
+    for (int half = 0; half < 2; half++) {
+        __m128i v = half ? hi : lo;
+        __m128i a = half ? hi1 : lo1;
+        __m128i b = half ? hi2 : lo2;
+        __m128i d = half ? hi3 : lo3;
+        __m128i e = half ? hi4 : lo4;
+
+        __m128i column = _mm_and_si128(_mm_and_si128(v, _mm_srli_epi16(v, 1)),
+                                       _mm_and_si128(_mm_and_si128(_mm_srli_epi16(v, 2), _mm_srli_epi16(v, 3)),
+                                                     _mm_srli_epi16(v, 4)));
+        __m128i row = _mm_and_si128(_mm_and_si128(v, a), _mm_and_si128(_mm_and_si128(b, d), e));
+        __m128i diagonal = _mm_and_si128(_mm_and_si128(v, _mm_srli_epi16(a, 1)),
+                                         _mm_and_si128(_mm_and_si128(_mm_srli_epi16(b, 2), _mm_srli_epi16(d, 3)),
+                                                       _mm_srli_epi16(e, 4)));
+        __m128i anti = _mm_and_si128(_mm_and_si128(v, _mm_slli_epi16(a, 1)),
+                                     _mm_and_si128(_mm_and_si128(_mm_slli_epi16(b, 2), _mm_slli_epi16(d, 3)),
+                                                   _mm_slli_epi16(e, 4)));
+        any = _mm_or_si128(any, _mm_or_si128(_mm_or_si128(column, row), _mm_or_si128(diagonal, anti)));
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) != 0xFFFF;
+}
+
+static int fives_sse2(const uint16_t* columns) {
+    return (side_has_five_sse2(columns) ? 1 : 0) | (side_has_five_sse2(columns + KERNEL_MAX_SIZE) ? 2 : 0);
+}
+#endif
+
+#if defined(LINE_KERNEL_HAVE_AVX2)
+// Columns x + K of a side, across the two 128-bit halves
+template <int K>
+__attribute__((target("avx2")))
+static inline __m256i shift_columns_avx2(__m256i v) {
+    return _mm256_alignr_epi8(_mm256_permute2x128_si256(v, v, 0x81), v, 2 * K);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i side_fives_avx2(const uint16_t* c) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c));
+    __m256i a = shift_columns_avx2<1>(v);
+    __m256i b = shift_columns_avx2<2>(v);
+    __m256i d = shift_columns_avx2<3>(v);
+    __m256i e = shift_columns_avx2<4>(v);
+
+    __m256i column = _mm256_and_si256(_mm256_and_si256(v, _mm256_srli_epi16(v, 1)),
+                                      _mm256_and_si256(_mm256_and_si256(_mm256_srli_epi16(v, 2), _mm256_srli_epi16(v, 3)),
+                                                       _mm256_srli_epi16(v, 4)));
+    __m256i row = _mm256_and_si256(_mm256_and_si256(v, a), _mm256_and_si256(_mm256_and_si256(b, d), e));
+    __m256i diagonal = _mm256_and_si256(_mm256_and_si256(v, _mm256_srli_epi16(a, 1)),
+                                        _mm256_and_si256(_mm256_and_si256(_mm256_srli_epi16(b, 2), _mm256_srli_epi16(d, 3)),
+                                                         _mm256_srli_epi16(e, 4)));
+    __m256i anti = _mm256_and_si256(_mm256_and_si256(v, _mm256_slli_epi16(a, 1)),
+                                    _mm256_and_si256(_mm256_and_si256(_mm256_slli_epi16(b, 2), _mm256_slli_epi16(d, 3)),
+                                                     _mm256_slli_epi16(e, 4)));
+    return _mm256_or_si256(_mm256_or_si256(column, row), _mm256_or_si256(diagonal, anti));
+}
+
+__attribute__((target("avx2")))
+static int fives_avx2(const uint16_t* columns) {
+    __m256i own = side_fives_avx2(columns);
+    __m256i enemy = side_fives_avx2(columns + KERNEL_MAX_SIZE);
+    return (_mm256_testz_si256(own, own) ? 0 : 1) | (_mm256_testz_si256(enemy, enemy) ? 0 : 2);
+}
+#endif
+
+#if defined(LINE_KERNEL_HAVE_NEON)
+static inline bool side_has_five_neon(const uint16_t* c) {
+    uint16x8_t zero = vdupq_n_u16(0);
+    uint16x8_t lo = vld1q_u16(c);
+    uint16x8_t hi = vld1q_u16(c + 8);
+
+    // Columns x + k: vext takes lanes k.. of the concatenation
+    uint16x8_t shifted_lo[5] = {lo, vextq_u16(lo, hi, 1), vextq_u16(lo, hi, 2), vextq_u16(lo, hi, 3),
+                                vextq_u16(lo, hi, 4)};
+    uint16x8_t shifted_hi[5] = {hi, vextq_u16(hi, zero, 1), vextq_u16(hi, zero, 2), vextq_u16(hi, zero, 3),
+                                vextq_u16(hi, zero, 4)};
+
+    uint16x8_t any = zero;
+    for (int half = 0; half < 2; half++) {
+        const uint16x8_t* s = half ? shifted_hi : shifted_lo;
+        uint16x8_t v = s[0];
+        uint16x8_t column = vandq_u16(vandq_u16(v, vshrq_n_u16(v, 1)),
+                                      vandq_u16(vandq_u16(vshrq_n_u16(v, 2), vshrq_n_u16(v, 3)), vshrq_n_u16(v, 4)));
+        uint16x8_t row = vandq_u16(vandq_u16(v, s[1]), vandq_u16(vandq_u16(s[2], s[3]), s[4]));
+        uint16x8_t diagonal = vandq_u16(vandq_u16(v, vshrq_n_u16(s[1], 1)),
+                                        vandq_u16(vandq_u16(vshrq_n_u16(s[2], 2), vshrq_n_u16(s[3], 3)),
+                                                  vshrq_n_u16(s[4], 4)));
+        uint16x8_t anti = vandq_u16(vandq_u16(v, vshlq_n_u16(s[1], 1)),
+                                    vandq_u16(vandq_u16(vshlq_n_u16(s[2], 2), vshlq_n_u16(s[3], 3)),
+                                              vshlq_n_u16(s[4], 4)));
+        any = vorrq_u16(any, vorrq_u16(vorrq_u16(column, row), vorrq_u16(diagonal, anti)));
+    }
+    uint64x2_t words = vreinterpretq_u64_u16(any);
+    return (vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1)) != 0;
+}
+
+static int fives_neon(const uint16_t* columns) {
+    return (side_has_five_neon(columns) ? 1 : 0) | (side_has_five_neon(columns + KERNEL_MAX_SIZE) ? 2 : 0);
+}
+#endif
+
+bool line_kernel_supported(LineKernel kernel) {
+    switch (kernel) {
+    case LINE_KERNEL_SCALAR:
+        return true;
+#if defined(__SSE2__)
+    case LINE_KERNEL_SSE2:
+        return true;
+#endif
+#if defined(LINE_KERNEL_HAVE_AVX2)
+    case LINE_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#if defined(LINE_KERNEL_HAVE_NEON)
+    case LINE_KERNEL_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+LineKernel best_line_kernel() {
+    static const LineKernel best = line_kernel_supported(LINE_KERNEL_AVX2) ? LINE_KERNEL_AVX2 :
+                                   line_kernel_supported(LINE_KERNEL_NEON) ? LINE_KERNEL_NEON :
+                                   line_kernel_supported(LINE_KERNEL_SSE2) ? LINE_KERNEL_SSE2 :
+                                   LINE_KERNEL_SCALAR;
+    return best;
+}
+
+const char* line_kernel_name(LineKernel kernel) {
+    switch (kernel) {
+    case LINE_KERNEL_SCALAR:
+        return "scalar";
+    case LINE_KERNEL_SSE2:
+        return "sse2";
+    case LINE_KERNEL_AVX2:
+        return "avx2";
+    case LINE_KERNEL_NEON:
+        return "neon";
+    }
+    return "unknown";
+}
+
+int find_fives(const uint16_t* columns, LineKernel kernel) {
+    switch (kernel) {
+#if defined(__SSE2__)
+    case LINE_KERNEL_SSE2:
+        return fives_sse2(columns);
+#endif
+#if defined(LINE_KERNEL_HAVE_AVX2)
+    case LINE_KERNEL_AVX2:
+        return fives_avx2(columns);
+#endif
+#if defined(LINE_KERNEL_HAVE_NEON)
+    case LINE_KERNEL_NEON:
+        return fives_neon(columns);
+#endif
+    default:
+        return fives_scalar(columns);
+    }
+}
+
+int find_fives(const uint16_t* columns) {
+    typedef int (*Kernel)(const uint16_t*);
+    static const Kernel kernel = []() -> Kernel {
+        switch (best_line_kernel()) {
+#if defined(__SSE2__)
+        case LINE_KERNEL_SSE2:
+            return fives_sse2;
+#endif
+#if defined(LINE_KERNEL_HAVE_AVX2)
+        case LINE_KERNEL_AVX2:
+            return fives_avx2;
+#endif
+#if defined(LINE_KERNEL_HAVE_NEON)
+        case LINE_KERNEL_NEON:
+            return fives_neon;
+#endif
+        default:
+            return fives_scalar;
+        }
+    }();
+    return kernel(columns);
+}
@@ -0,0 +1,41 @@
+#ifndef LINE_KERNEL_H
+#define LINE_KERNEL_H
+
+#include <cstdint>
+
+// Five-in-a-row detection for both colours at once on boards of up to
+// 16x16. The board is given as column masks: 32 uint16_t values, side 0's
+// columns 0..15 followed by side 1's, with bit y of column x set for a
+// stone on (x, y). A whole board side is then 256 bits, and every line
+// direction is a lane shift plus a bit shift:
+//
+//   column     c[x] & c[x] >> 1 & ... & c[x] >> 4
+//   row        c[x] & c[x+1] & ... & c[x+4]
+//   diagonal   c[x] & c[x+1] >> 1 & ... & c[x+4] >> 4
+//   anti       c[x] & c[x+1] << 1 & ... & c[x+4] << 4
+//
+// Columns and rows past the board edge must be zero.
+const int KERNEL_MAX_SIZE = 16;
+
+enum LineKernel {
+    LINE_KERNEL_SCALAR = 0,     // portable C++
+    LINE_KERNEL_SSE2 = 1,       // x86 SSE2, two 128-bit registers per side
+    LINE_KERNEL_AVX2 = 2,       // x86 AVX2, one 256-bit register per side
+    LINE_KERNEL_NEON = 3        // ARM NEON (Raspberry Pi), two registers per side
+};
+
+// True if `kernel` is compiled in and this CPU can run it
+bool line_kernel_supported(LineKernel kernel);
+
+// The fastest supported kernel, detected once at runtime
+LineKernel best_line_kernel();
+
+const char* line_kernel_name(LineKernel kernel);
+
+// Bit `side` of the result is set if that side has five in a row
+int find_fives(const uint16_t* columns, LineKernel kernel);
+
+// Same with best_line_kernel()
+int find_fives(const uint16_t* columns);
+
+#endif // LINE_KERNEL_H
@@ -3,55 +3,71 @@
 
 #include <vector>
 #include <utility>
-#include <set>
 #include <map>
-#include <algorithm>
-#include <tuple>
-#include <iostream>
+#include <string>
+#include <chrono>
+#include <memory>
+#include "minimax_engine.h"
 
+// Runtime-sized front end: picks the MinimaxEngine specialised for the
+// board size (12x12, 13x13 or 15x15) or the runtime-sized one otherwise
+// and forwards every call to it.
 class MinimaxAlgorithm {
 public:
-    // Constructor
-    MinimaxAlgorithm(std::pair<int, int> board_size = {12, 12}, int search_depth = 3, double attack_ratio = 1.0);
+    // Constructor (tt_entries: transposition table size, 0 disables it;
+    // each entry is 16 bytes. thread_count: root moves are split across
+    // this many threads; 1 searches serially and is deterministic.
+    // search_options: algorithm switches, see search_options.h)
+    MinimaxAlgorithm(std::pair<int, int> board_size = {12, 12}, int search_depth = 3, double attack_ratio = 1.0,
+                     std::size_t tt_entries = 1 << 16, int thread_count = 1,
+                     const SearchOptions& search_options = SearchOptions());
     
-    // Get the best move for AI
+    // The engine owns the transposition table and helper threads
+    MinimaxAlgorithm(const MinimaxAlgorithm&) = delete;
+    MinimaxAlgorithm& operator=(const MinimaxAlgorithm&) = delete;
+    
+    // Get the best move for AI (pieces outside the board are ignored)
     std::pair<int, int> get_next_move(const std::vector<std::pair<int, int>>& player_pieces, 
                                const std::vector<std::pair<int, int>>& opponent_pieces);
     
+    // Time-budgeted search: deepen 1, 2, 3... until the budget runs out and
+    // return the best move of the last completed depth. Depth 1 always
+    // completes so a move is returned even with a tiny budget.
+    std::pair<int, int> get_next_move(const std::vector<std::pair<int, int>>& player_pieces,
+                               const std::vector<std::pair<int, int>>& opponent_pieces,
+                               std::chrono::milliseconds time_budget);
+    
     // Get statistics
     std::map<std::string, int> get_statistics() const;
-
-private:
-    // Board dimensions
-    int COLUMN;
-    int ROW;
-    int DEPTH;
-    double ratio;
     
-    // Statistics
-    int cut_count;
-    int search_count;
+    // Game session. Instead of passing every stone to each search, play
+    // the moves on the engine's board as they happen; the board, the
+    // evaluation caches and the transposition table then stay warm
+    // between turns, and when the moves played follow the previous
+    // principal variation the next search tries the rest of it first.
+    // The get_next_move overloads above start a new game each call.
+    //
+    // player 0 is the AI (player_pieces), 1 the opponent. apply_move
+    // returns false for a cell that is off the board or taken; undo_move
+    // takes back the last stone and returns false on an empty board.
+    void new_game();
+    bool apply_move(int player, std::pair<int, int> cell);
+    bool undo_move();
     
-    // Game state
-    std::vector<std::pair<int, int>> player_pieces;
-    std::vector<std::pair<int, int>> opponent_pieces;
-    std::vector<std::pair<int, int>> all_pieces;
-    std::vector<std::pair<int, int>> all_positions;
-    std::pair<int, int> next_move;
+    // Best move for the AI on the session board, at the fixed depth or
+    // with a time budget; the centre on an empty board, {-1, -1} if the
+    // game is already won or the board is full
+    std::pair<int, int> get_next_move();
+    std::pair<int, int> get_next_move(std::chrono::milliseconds time_budget);
     
-    // Shape scores for pattern evaluation
-    std::vector<std::pair<int, std::vector<int>>> shape_score;
-    
-    // Algorithm methods
-    int negamax(bool is_ai, int depth, int alpha, int beta);
-    void order_moves(std::vector<std::pair<int, int>>& blank_list);
-    bool has_neighbor(const std::pair<int, int>& point);
-    int evaluation(bool is_ai);
-    int cal_score(int m, int n, int x_direct, int y_direct, 
-                 const std::vector<std::pair<int, int>>& enemy_list, 
-                 const std::vector<std::pair<int, int>>& my_list, 
-                 std::vector<std::tuple<int, std::vector<std::pair<int, int>>, std::pair<int, int>>>& score_all_arr);
-    bool check_win(const std::vector<std::pair<int, int>>& pieces);
+    // Memory-map an opening book built by gobang_book_builder for this
+    // board size. Every get_next_move then plays the book move when the
+    // position (in any rotation or reflection) is in it, without searching.
+    // Returns false, leaving no book, if the file is missing or mismatched.
+    bool load_opening_book(const std::string& path);
+
+private:
+    std::unique_ptr<SearchEngine> engine;
 };
 
-#endif // MINIMAX_ALGORITHM_H 
\ No newline at end of file
+#endif // MINIMAX_ALGORITHM_H
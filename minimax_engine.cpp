@@ -0,0 +1,997 @@
+#include "minimax_engine.h"
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// Threat-space search budgets: before the main search, and at each leaf
+static const int VCF_ROOT_FOURS = 12;
+static const int VCF_ROOT_NODES = 20000;
+static const int VCF_LEAF_FOURS = 2;
+static const int VCF_LEAF_NODES = 32;
+
+// Bound wider than any evaluation, for the full window
+static const int SCORE_INFINITY = 99999999;
+
+// Constructor implementation
+template <int Cols, int Rows>
+MinimaxEngine<Cols, Rows>::MinimaxEngine(std::pair<int, int> board_size, int search_depth, double attack_ratio,
+                                         std::size_t tt_entries, int thread_count,
+                                         const SearchOptions& search_options) {
+    // Initialize basic parameters
+    column_count = Cols > 0 ? Cols : board_size.first;
+    row_count = Rows > 0 ? Rows : board_size.second;
+    DEPTH = search_depth;
+    ratio = attack_ratio;
+    options = search_options;
+    
+    // Initialize statistics
+    cut_count = 0;
+    search_count = 0;
+    completed_depth = 0;
+    search_time_ms = 0;
+    tt_hits = 0;
+    tt_misses = 0;
+    tt_stores = 0;
+    tt_symmetry_moves = 0;
+    vcf_found = 0;
+    vcf_length = 0;
+    vcf_nodes = 0;
+    vcf_leaf_wins = 0;
+    pv_reused = 0;
+    book_hit = 0;
+    pvs_researches = 0;
+    aspiration_researches = 0;
+    reductions = 0;
+    reduction_researches = 0;
+    extensions = 0;
+    
+    // A forced win scores half of what the evaluation gives a five
+    vcf_win_score = static_cast<int>(99999999 * ratio * 0.1) / 2;
+    
+    // Initialize search control
+    root_depth = DEPTH;
+    root_score = 0;
+    root_score_valid = false;
+    time_limited = false;
+    search_aborted = false;
+    node_clock = 0;
+    follow_pv = false;
+    
+    // Initialize next move
+    next_move = {0, 0};
+    
+    // Initialize the packed board and the line table
+    board.reset(columns(), rows());
+    build_line_table();
+    evaluator.reset(board);
+    
+    // Candidate moves are the empty cells adjacent to a stone, the same
+    // cells the search used to keep by checking every neighbour
+    candidates.reset(columns(), rows(), 1);
+    threat_cells.reset(columns(), rows(), 2);
+    move_history.reserve(cell_count());
+    moves_since_search.reserve(cell_count());
+    arena.reserve(DEPTH + 1, cell_count());
+    
+    // Initialize hashing and the transposition table
+    zobrist.reset(cell_count());
+    tt.resize(tt_entries);
+    table = &tt;
+    position_keys.reset(columns(), rows());
+    
+    // Start with an empty session board
+    new_game();
+    
+    // Helper engines for the extra search threads share this table
+    threads = std::max(thread_count, 1);
+    for (int i = 1; i < threads; i++) {
+        helpers.emplace_back(new MinimaxEngine(board_size, search_depth, attack_ratio, 0, 1, search_options));
+        helpers.back()->table = &tt;
+    }
+}
+
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::build_line_table() {
+    // threat_score()'s directions, in its order: the shape table is not
+    // mirror-symmetric, so the anti-diagonal must run the same way
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    
+    line_cells.assign(cell_count() * 4 * LINE_SPAN, -1);
+    for (int x = 0; x < columns(); x++) {
+        for (int y = 0; y < rows(); y++) {
+            int* line = &line_cells[cell_index(x, y) * 4 * LINE_SPAN];
+            for (int d = 0; d < 4; d++) {
+                for (int k = -5; k <= 5; k++) {
+                    int cx = x + k * directions[d][0];
+                    int cy = y + k * directions[d][1];
+                    line[d * LINE_SPAN + k + 5] = board.in_bounds(cx, cy) ? cell_index(cx, cy) : -1;
+                }
+            }
+        }
+    }
+}
+
+template <int Cols, int Rows>
+std::pair<int, int> MinimaxEngine<Cols, Rows>::get_next_move(
+    const std::vector<std::pair<int, int>>& player_pieces_input, 
+    const std::vector<std::pair<int, int>>& opponent_pieces_input
+) {
+    load_position(player_pieces_input, opponent_pieces_input);
+    return get_next_move();
+}
+
+template <int Cols, int Rows>
+std::pair<int, int> MinimaxEngine<Cols, Rows>::get_next_move(
+    const std::vector<std::pair<int, int>>& player_pieces_input,
+    const std::vector<std::pair<int, int>>& opponent_pieces_input,
+    std::chrono::milliseconds time_budget
+) {
+    load_position(player_pieces_input, opponent_pieces_input);
+    return get_next_move(time_budget);
+}
+
+template <int Cols, int Rows>
+std::pair<int, int> MinimaxEngine<Cols, Rows>::get_next_move() {
+    auto start = std::chrono::steady_clock::now();
+    begin_search();
+    
+    // Run the Minimax algorithm at the fixed depth, unless the position
+    // is in the opening book or a forced win by continuous fours is
+    // already on the board
+    time_limited = false;
+    if (!search_root_book() && !search_root_vcf()) {
+        for (int depth = options.iterative_deepening ? 1 : DEPTH; depth <= DEPTH; depth++) {
+            search_root(depth);
+        }
+    }
+    
+    search_time_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    
+    // Return the best move
+    return next_move;
+}
+
+template <int Cols, int Rows>
+std::pair<int, int> MinimaxEngine<Cols, Rows>::get_next_move(std::chrono::milliseconds time_budget) {
+    auto start = std::chrono::steady_clock::now();
+    deadline = start + time_budget;
+    begin_search();
+    
+    // Deepen until time runs out or no empty cell is left to search
+    int max_depth = std::min(cell_count() - board.count(0) - board.count(1), static_cast<int>(MAX_DEPTH));
+    std::pair<int, int> best_move = next_move;
+    if (search_root_book() || search_root_vcf()) {
+        best_move = next_move;
+        max_depth = 0;
+    }
+    for (int depth = 1; depth <= max_depth; depth++) {
+        time_limited = depth > 1;
+        if (!search_root(depth)) {
+            break;
+        }
+        best_move = next_move;
+        if (time_limited && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+    time_limited = false;
+    next_move = best_move;
+    
+    search_time_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    return next_move;
+}
+
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::new_game() {
+    board.clear();
+    evaluator.reset(board);
+    candidates.reset(columns(), rows(), candidates.radius());
+    threat_cells.reset(columns(), rows(), threat_cells.radius());
+    move_history.clear();
+    position_keys.clear();
+    
+    // Forget everything learnt from earlier searches
+    tt.clear();
+    principal_variation.clear();
+    moves_since_search.clear();
+    history[0].assign(cell_count(), 0);
+    history[1].assign(cell_count(), 0);
+}
+
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::apply_move(int player, std::pair<int, int> cell) {
+    if ((player != 0 && player != 1) || !board.in_bounds(cell.first, cell.second) ||
+        board.occupied(cell.first, cell.second)) {
+        return false;
+    }
+    make_move(player == 0, cell);
+    moves_since_search.push_back({player, cell_index(cell.first, cell.second)});
+    return true;
+}
+
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::undo_move() {
+    if (move_history.empty()) {
+        return false;
+    }
+    std::pair<int, int> last = move_history.back();
+    unmake_move(board.has(0, last.first, last.second), last);
+    
+    // Taking back a stone from before the last search invalidates its PV
+    if (!moves_since_search.empty()) {
+        moves_since_search.pop_back();
+    } else {
+        principal_variation.clear();
+    }
+    return true;
+}
+
+// Stateless entry: start a new game holding exactly these pieces
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::load_position(
+    const std::vector<std::pair<int, int>>& player_pieces_input,
+    const std::vector<std::pair<int, int>>& opponent_pieces_input
+) {
+    // Convert the input pieces to the packed board once
+    new_game();
+    for (const auto& pt : player_pieces_input) {
+        apply_move(0, pt);
+    }
+    for (const auto& pt : opponent_pieces_input) {
+        apply_move(1, pt);
+    }
+}
+
+// Per-search setup. The position, transposition table and history carry
+// over from the previous turn; statistics start from zero.
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::begin_search() {
+    cut_count = 0;
+    search_count = 0;
+    completed_depth = 0;
+    tt_hits = 0;
+    tt_misses = 0;
+    tt_stores = 0;
+    tt_symmetry_moves = 0;
+    vcf_found = 0;
+    vcf_length = 0;
+    vcf_nodes = 0;
+    vcf_leaf_wins = 0;
+    book_hit = 0;
+    pvs_researches = 0;
+    aspiration_researches = 0;
+    reductions = 0;
+    reduction_researches = 0;
+    extensions = 0;
+    root_score_valid = false;
+    
+    // Stays {-1, -1} if there is nothing to search: the game is already
+    // won or no empty cell is left. The empty board has no candidates
+    // either, but opens in the centre
+    if (move_history.empty()) {
+        next_move = {columns() / 2, rows() / 2};
+    } else {
+        next_move = {-1, -1};
+    }
+    
+    // If the moves played since the last search (AI first) are the start
+    // of its principal variation, the rest of it is tried first again
+    size_t played = moves_since_search.size();
+    bool on_line = played <= principal_variation.size();
+    for (size_t i = 0; i < played && on_line; i++) {
+        const auto& pv_move = principal_variation[i];
+        on_line = moves_since_search[i].first == static_cast<int>(i % 2) &&
+                  moves_since_search[i].second == cell_index(pv_move.first, pv_move.second);
+    }
+    if (on_line) {
+        principal_variation.erase(principal_variation.begin(), principal_variation.begin() + played);
+    } else {
+        principal_variation.clear();
+    }
+    pv_reused = static_cast<int>(principal_variation.size());
+    moves_since_search.clear();
+    
+    // Killers are per ply, and plies shift between turns; history is aged
+    killer_moves.assign(ply_count(std::max(DEPTH, static_cast<int>(MAX_DEPTH))), {-1, -1});
+    for (int side = 0; side < 2; side++) {
+        for (int cell = 0; cell < cell_count(); cell++) {
+            history[side][cell] /= 2;
+        }
+    }
+}
+
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::load_opening_book(const std::string& path) {
+    if (!book.open(path) || book.columns() != columns() || book.rows() != rows()) {
+        book.close();
+        return false;
+    }
+    return true;
+}
+
+// Play the book move if this position, in any orientation, is in the
+// opening book. The stored move is mapped back to the board's orientation.
+// An entry holds only a move, searched offline in the canonical
+// orientation, so there is no score or bound to carry across symmetries.
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::search_root_book() {
+    if (!book.is_open()) {
+        return false;
+    }
+    
+    int symmetry;
+    BookEntry entry;
+    if (!book.probe(position_keys.canonical(symmetry), entry) || entry.move >= cell_count()) {
+        return false;
+    }
+    int cell = from_canonical(symmetry, entry.move);
+    std::pair<int, int> move = {cell / rows(), cell % rows()};
+    if (board.occupied(move.first, move.second)) {
+        return false;
+    }
+    
+    next_move = move;
+    book_hit = 1;
+    completed_depth = 0;
+    return true;
+}
+
+// Look for a VCF for the AI before searching full width. On success the
+// first four of the line becomes next_move.
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::search_root_vcf() {
+    if (game_won()) {
+        return false;
+    }
+    
+    bool found = threat_search.find_vcf(board, threat_cells, 0, VCF_ROOT_FOURS, VCF_ROOT_NODES, vcf_line);
+    vcf_nodes += threat_search.nodes();
+    if (!found) {
+        return false;
+    }
+    
+    next_move = vcf_line[0];
+    vcf_found = 1;
+    vcf_length = static_cast<int>(vcf_line.size() + 1) / 2;
+    completed_depth = 0;
+    return true;
+}
+
+// One full-width search from the root. Returns false if the deadline
+// cut it short, in which case next_move and the PV are left untouched.
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::search_root(int depth) {
+    root_depth = depth;
+    search_aborted = false;
+    node_clock = 0;
+    arena.reserve(ply_count(depth), cell_count());
+    if (static_cast<int>(pv_table.size()) < ply_count(depth)) {
+        pv_table.assign(ply_count(depth), std::vector<std::pair<int, int>>(ply_count(depth)));
+    }
+    
+    // Within an iterative deepening run, start from a narrow window around
+    // the last iteration's score. A score on a window edge is only a bound:
+    // open that side and search again.
+    int alpha = -SCORE_INFINITY;
+    int beta = SCORE_INFINITY;
+    if (options.aspiration_windows && root_score_valid) {
+        alpha = std::max(root_score - options.aspiration_window, -SCORE_INFINITY);
+        beta = std::min(root_score + options.aspiration_window, SCORE_INFINITY);
+    }
+    
+    std::pair<int, int> previous_move = next_move;
+    int score;
+    while (true) {
+        follow_pv = !principal_variation.empty();
+        pv_length.assign(ply_count(depth), 0);
+        if (threads > 1 && depth > 1) {
+            score = search_root_parallel(depth, alpha, beta);
+        } else {
+            score = negamax(true, depth, 0, alpha, beta);
+        }
+        if (search_aborted) {
+            break;
+        }
+        if (score <= alpha && alpha > -SCORE_INFINITY) {
+            alpha = -SCORE_INFINITY;
+        } else if (score >= beta && beta < SCORE_INFINITY) {
+            beta = SCORE_INFINITY;
+        } else {
+            break;
+        }
+        aspiration_researches++;
+    }
+    
+    if (search_aborted) {
+        next_move = previous_move;
+        return false;
+    }
+    
+    principal_variation.assign(pv_table[0].begin(), pv_table[0].begin() + pv_length[0]);
+    completed_depth = depth;
+    root_score = score;
+    root_score_valid = true;
+    return true;
+}
+
+// Root splitting: the first root move is searched alone to get a bound
+// (young brothers wait), then the remaining moves are handed out to the
+// helper threads and this one, which share alpha and the table.
+template <int Cols, int Rows>
+int MinimaxEngine<Cols, Rows>::search_root_parallel(int depth, int alpha, int beta) {
+    int alpha_orig = alpha;
+    pv_length[0] = 0;
+    
+    if (game_won()) {
+        return evaluation(true);
+    }
+    
+    uint64_t key = position_keys.key(0);
+    int tt_move;
+    TTEntry entry;
+    probe_table(0, entry, tt_move);
+    
+    bool on_pv = follow_pv;
+    std::vector<std::pair<int, int>>& root_moves = arena.ply(0).moves;
+    std::pair<int, int> pv_move;
+    generate_moves(true, 0, tt_move, root_moves, pv_move);
+    search_count += static_cast<int>(root_moves.size());
+    if (root_moves.empty()) {
+        return alpha;
+    }
+    if (next_move.first < 0) {
+        next_move = root_moves[0];
+    }
+    
+    std::mutex best_lock;
+    int best_move = -1;
+    auto record = [&](MinimaxEngine& worker, const std::pair<int, int>& move, int value) {
+        std::lock_guard<std::mutex> guard(best_lock);
+        if (value > alpha) {
+            alpha = value;
+            best_move = cell_index(move.first, move.second);
+            next_move = move;
+            pv_table[0][0] = move;
+            for (int i = 1; i < worker.pv_length[1]; i++) {
+                pv_table[0][i] = worker.pv_table[1][i];
+            }
+            pv_length[0] = std::max(worker.pv_length[1], 1);
+        }
+    };
+    
+    // Eldest brother
+    make_move(true, root_moves[0]);
+    int value = search_move(true, root_moves[0], 0, depth, 0, alpha, beta, on_pv && root_moves[0] == pv_move);
+    unmake_move(true, root_moves[0]);
+    if (search_aborted) {
+        return 0;
+    }
+    record(*this, root_moves[0], value);
+    
+    // Younger brothers, shared out one move at a time
+    std::atomic<int> next_index(1);
+    auto work = [&](MinimaxEngine* worker) {
+        worker->follow_pv = false;
+        while (!worker->search_aborted) {
+            int i = next_index++;
+            if (i >= static_cast<int>(root_moves.size())) {
+                break;
+            }
+            int bound;
+            {
+                std::lock_guard<std::mutex> guard(best_lock);
+                bound = alpha;
+            }
+            worker->make_move(true, root_moves[i]);
+            int score = worker->search_move(true, root_moves[i], i, depth, 0, bound, beta, false);
+            worker->unmake_move(true, root_moves[i]);
+            if (!worker->search_aborted) {
+                record(*worker, root_moves[i], score);
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (auto& helper : helpers) {
+        sync_helper(*helper);
+        pool.emplace_back(work, helper.get());
+    }
+    work(this);
+    for (auto& worker : pool) {
+        worker.join();
+    }
+    
+    // Fold the helpers' statistics into ours
+    for (auto& helper : helpers) {
+        search_aborted = search_aborted || helper->search_aborted;
+        cut_count += helper->cut_count;
+        search_count += helper->search_count;
+        tt_hits += helper->tt_hits;
+        tt_misses += helper->tt_misses;
+        tt_stores += helper->tt_stores;
+        tt_symmetry_moves += helper->tt_symmetry_moves;
+        pvs_researches += helper->pvs_researches;
+        reductions += helper->reductions;
+        reduction_researches += helper->reduction_researches;
+        extensions += helper->extensions;
+        vcf_nodes += helper->vcf_nodes;
+        vcf_leaf_wins += helper->vcf_leaf_wins;
+    }
+    if (search_aborted) {
+        return 0;
+    }
+    
+    // Outside the window the score is only a bound
+    alpha = std::min(alpha, beta);
+    TTBound bound = alpha >= beta ? TT_LOWER : (alpha > alpha_orig ? TT_EXACT : TT_UPPER);
+    table->store(key, depth, bound, alpha, best_move);
+    tt_stores++;
+    return alpha;
+}
+
+// Probe the table for the position, `key_side` being the side-to-move
+// part of its key. Only an entry for this exact position is returned, as
+// its score and bound may cut: the evaluation is not invariant under the
+// board symmetries, so a rotated or reflected position can score
+// differently. Failing that, the move stored for a rotation or reflection
+// is still a good first try, and is mapped back into tt_move.
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::probe_table(uint64_t key_side, TTEntry& entry, int& tt_move) {
+    tt_move = -1;
+    uint64_t key = position_keys.key(0);
+    if (table->probe(key ^ key_side, entry)) {
+        tt_hits++;
+        tt_move = entry.move;
+        return true;
+    }
+    tt_misses++;
+    
+    TTEntry mirrored;
+    for (int s = 1; s < position_keys.count(); s++) {
+        uint64_t other = position_keys.key(s);
+        if (other != key && table->probe(other ^ key_side, mirrored)) {
+            tt_symmetry_moves++;
+            tt_move = from_canonical(s, mirrored.move);
+            break;
+        }
+    }
+    return false;
+}
+
+// Copy the root position and search settings into a helper engine
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::sync_helper(MinimaxEngine& helper) const {
+    helper.board = board;
+    helper.evaluator = evaluator;
+    helper.candidates = candidates;
+    helper.threat_cells = threat_cells;
+    helper.position_keys = position_keys;
+    helper.move_history = move_history;
+    
+    helper.root_depth = root_depth;
+    helper.time_limited = time_limited;
+    helper.deadline = deadline;
+    helper.search_aborted = false;
+    helper.node_clock = 0;
+    helper.arena.reserve(ply_count(root_depth), cell_count());
+    if (static_cast<int>(helper.pv_table.size()) < ply_count(root_depth)) {
+        helper.pv_table.assign(ply_count(root_depth), std::vector<std::pair<int, int>>(ply_count(root_depth)));
+    }
+    helper.pv_length.assign(ply_count(root_depth), 0);
+    helper.principal_variation.clear();
+    helper.killer_moves.assign(ply_count(std::max(DEPTH, static_cast<int>(MAX_DEPTH))), {-1, -1});
+    helper.history[0].assign(cell_count(), 0);
+    helper.history[1].assign(cell_count(), 0);
+    
+    helper.cut_count = 0;
+    helper.search_count = 0;
+    helper.tt_hits = 0;
+    helper.tt_misses = 0;
+    helper.tt_stores = 0;
+    helper.tt_symmetry_moves = 0;
+    helper.pvs_researches = 0;
+    helper.reductions = 0;
+    helper.reduction_researches = 0;
+    helper.extensions = 0;
+    helper.vcf_nodes = 0;
+    helper.vcf_leaf_wins = 0;
+}
+
+template <int Cols, int Rows>
+std::map<std::string, int> MinimaxEngine<Cols, Rows>::get_statistics() const {
+    return {
+        {"cut_count", cut_count},
+        {"search_count", search_count},
+        {"depth", completed_depth},
+        {"time_ms", search_time_ms},
+        {"tt_hits", tt_hits},
+        {"tt_misses", tt_misses},
+        {"tt_stores", tt_stores},
+        {"tt_symmetry_moves", tt_symmetry_moves},
+        {"tt_entries", static_cast<int>(tt.size())},
+        {"threads", threads},
+        {"vcf_found", vcf_found},
+        {"vcf_length", vcf_length},
+        {"vcf_nodes", vcf_nodes},
+        {"vcf_leaf_wins", vcf_leaf_wins},
+        {"pv_reused", pv_reused},
+        {"book_hit", book_hit},
+        {"pvs_researches", pvs_researches},
+        {"aspiration_researches", aspiration_researches},
+        {"reductions", reductions},
+        {"reduction_researches", reduction_researches},
+        {"extensions", extensions}
+    };
+}
+
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::make_move(bool is_ai, const std::pair<int, int>& point) {
+    int side = is_ai ? 0 : 1;
+    board.make(side, point.first, point.second);
+    evaluator.update(board, point.first, point.second);
+    candidates.add_stone(point.first, point.second);
+    threat_cells.add_stone(point.first, point.second);
+    position_keys.toggle(zobrist, side, cell_index(point.first, point.second));
+    move_history.push_back(point);
+}
+
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::unmake_move(bool is_ai, const std::pair<int, int>& point) {
+    int side = is_ai ? 0 : 1;
+    board.unmake(side, point.first, point.second);
+    evaluator.update(board, point.first, point.second);
+    candidates.remove_stone(point.first, point.second);
+    threat_cells.remove_stone(point.first, point.second);
+    position_keys.toggle(zobrist, side, cell_index(point.first, point.second));
+    move_history.pop_back();
+}
+
+template <int Cols, int Rows>
+int MinimaxEngine<Cols, Rows>::negamax(bool is_ai, int depth, int ply, int alpha, int beta) {
+    // Check if the game is over or if the search depth is reached.
+    // Below the root only the stone just placed (by the side not to move)
+    // can have completed a five.
+    pv_length[ply] = ply;
+    
+    // Give up on this iteration once the deadline has passed
+    if (time_limited && (++node_clock & 1023) == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+        search_aborted = true;
+    }
+    if (search_aborted) {
+        return 0;
+    }
+    
+    bool game_over;
+    if (ply == 0 || move_history.empty()) {
+        game_over = game_won();
+    } else {
+        const auto& last = move_history.back();
+        game_over = five_at(is_ai ? 1 : 0, cell_index(last.first, last.second));
+    }
+    
+    if (game_over) {
+        return evaluation(is_ai);
+    }
+    
+    // Quiescence: a leaf where the side to move has a short forced win
+    // by continuous fours is scored as won
+    if (depth == 0) {
+        bool forced = threat_search.find_vcf(board, threat_cells, is_ai ? 0 : 1, VCF_LEAF_FOURS,
+                                             VCF_LEAF_NODES, vcf_line);
+        vcf_nodes += threat_search.nodes();
+        if (forced) {
+            vcf_leaf_wins++;
+            return vcf_win_score;
+        }
+        return evaluation(is_ai);
+    }
+    
+    // Probe the transposition table. The root always searches so that
+    // next_move gets set; everywhere else a deep enough bound can cut.
+    int alpha_orig = alpha;
+    uint64_t side = is_ai ? 0 : zobrist.side_to_move();
+    uint64_t key = position_keys.key(0) ^ side;
+    int tt_move;
+    TTEntry entry;
+    if (probe_table(side, entry, tt_move)) {
+        if (ply != 0 && entry.depth >= depth) {
+            if (entry.bound == TT_EXACT) {
+                return std::max(alpha, std::min(beta, static_cast<int>(entry.score)));
+            }
+            if (entry.bound == TT_LOWER && entry.score >= beta) {
+                return beta;
+            }
+            if (entry.bound == TT_UPPER && entry.score <= alpha) {
+                return alpha;
+            }
+        }
+    }
+    
+    // Candidate moves in search order, in this ply's arena buffer
+    bool on_pv = follow_pv;
+    std::vector<std::pair<int, int>>& blank_list = arena.ply(ply).moves;
+    std::pair<int, int> pv_move;
+    generate_moves(is_ai, ply, tt_move, blank_list, pv_move);
+    
+    // A lost root may score no move above alpha; still answer a legal one
+    if (ply == 0 && next_move.first < 0 && !blank_list.empty()) {
+        next_move = blank_list[0];
+    }
+    
+    int best_move = -1;
+    
+    // Iterate through each candidate move
+    for (int move_number = 0; move_number < static_cast<int>(blank_list.size()); move_number++) {
+        const auto& next_step = blank_list[move_number];
+        search_count++;
+        
+        // Simulate placing a piece
+        make_move(is_ai, next_step);
+        
+        // Recursive search
+        int value = search_move(is_ai, next_step, move_number, depth, ply, alpha, beta,
+                                on_pv && next_step == pv_move);
+        
+        // Undo the move
+        unmake_move(is_ai, next_step);
+        
+        // Abandon the node without touching the table or the PV
+        if (search_aborted) {
+            return 0;
+        }
+        
+        // Update the best value
+        if (value > alpha) {
+            best_move = cell_index(next_step.first, next_step.second);
+            if (ply == 0) {
+                next_move = next_step;
+            }
+            
+            // Extend the principal variation with the child's line
+            pv_table[ply][ply] = next_step;
+            for (int i = ply + 1; i < pv_length[ply + 1]; i++) {
+                pv_table[ply][i] = pv_table[ply + 1][i];
+            }
+            pv_length[ply] = std::max(pv_length[ply + 1], ply + 1);
+            
+            // Alpha-beta pruning
+            if (value >= beta) {
+                cut_count++;
+                record_cutoff(is_ai, ply, depth, next_step);
+                table->store(key, depth, TT_LOWER, beta, best_move);
+                tt_stores++;
+                return beta;
+            }
+            alpha = value;
+        }
+    }
+    
+    table->store(key, depth, alpha > alpha_orig ? TT_EXACT : TT_UPPER, alpha, best_move);
+    tt_stores++;
+    return alpha;
+}
+
+// Score of `move`, the move_number-th tried at a node of `depth` and
+// already made by the side `is_ai`, from that side's point of view. Fours
+// are forcing and searched a ply deeper, up to MAX_EXTENSIONS plies per
+// line. A late quiet move is first searched a ply shallower with a null
+// window and only gets the full search if it beats alpha. With PVS the
+// first move is assumed best and the others only have to be shown worse,
+// with a null window; one that is not gets the full window to find its
+// score. Leaves score exactly whatever the window, so above them it need not.
+template <int Cols, int Rows>
+int MinimaxEngine<Cols, Rows>::search_move(bool is_ai, const std::pair<int, int>& move, int move_number,
+                                           int depth, int ply, int alpha, int beta, bool pv_child) {
+    int child_depth = depth - 1;
+    bool four = (options.four_extensions || options.late_move_reductions) &&
+                four_at(is_ai ? 0 : 1, cell_index(move.first, move.second));
+    if (four && options.four_extensions && ply + depth < root_depth + MAX_EXTENSIONS) {
+        extensions++;
+        child_depth++;
+    }
+    
+    int value;
+    if (options.late_move_reductions && !four && !pv_child && move_number >= options.reduction_move_count &&
+        depth >= options.reduction_min_depth && child_depth > 1) {
+        reductions++;
+        follow_pv = false;
+        value = -negamax(!is_ai, child_depth - 1, ply + 1, -alpha - 1, -alpha);
+        if (value <= alpha || search_aborted) {
+            return value;
+        }
+        reduction_researches++;
+    }
+    
+    follow_pv = pv_child;
+    if (options.principal_variation_search && move_number > 0) {
+        value = -negamax(!is_ai, child_depth, ply + 1, -alpha - 1, -alpha);
+        if (value > alpha && value < beta && child_depth > 0 && !search_aborted) {
+            pvs_researches++;
+            follow_pv = pv_child;
+            value = -negamax(!is_ai, child_depth, ply + 1, -beta, -alpha);
+        }
+    } else {
+        value = -negamax(!is_ai, child_depth, ply + 1, -beta, -alpha);
+    }
+    return value;
+}
+
+// Candidate cells (empty cells next to a stone) in search order
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::generate_moves(
+    bool is_ai, int ply, int tt_move, std::vector<std::pair<int, int>>& blank_list, std::pair<int, int>& pv_move
+) {
+    blank_list.clear();
+    candidates.collect(blank_list);
+    
+    // Along the previous iteration's principal variation its move goes first
+    pv_move = {-1, -1};
+    int pv_cell = -1;
+    if (follow_pv && ply < static_cast<int>(principal_variation.size())) {
+        pv_move = principal_variation[ply];
+        pv_cell = cell_index(pv_move.first, pv_move.second);
+    }
+    
+    order_moves(is_ai, ply, tt_move, pv_cell, blank_list);
+    
+    // Below the root, only the best candidates by that order are searched
+    if (options.candidate_cap && ply > 0 && static_cast<int>(blank_list.size()) > options.candidate_limit) {
+        blank_list.resize(options.candidate_limit);
+    }
+}
+
+// Sort candidates: PV move, transposition table move, killer moves, then
+// the rest by static threat (own shape made plus enemy shape blocked)
+// plus history score
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::order_moves(
+    bool is_ai, int ply, int tt_move, int pv_cell, std::vector<std::pair<int, int>>& blank_list
+) {
+    const long long PV_BONUS = 4LL << 40;
+    const long long TT_BONUS = 3LL << 40;
+    const long long KILLER_BONUS = 1LL << 40;
+    
+    int side = is_ai ? 0 : 1;
+    std::vector<ScoredMove>& scored = arena.ply(ply).scored;
+    scored.clear();
+    
+    for (const auto& pos : blank_list) {
+        int cell = cell_index(pos.first, pos.second);
+        long long score;
+        if (cell == pv_cell) {
+            score = PV_BONUS;
+        } else if (cell == tt_move) {
+            score = TT_BONUS;
+        } else if (cell == killer_moves[ply].first) {
+            score = KILLER_BONUS + 1;
+        } else if (cell == killer_moves[ply].second) {
+            score = KILLER_BONUS;
+        } else {
+            score = static_cast<long long>(threat_estimate(side, cell)) + threat_estimate(1 - side, cell) +
+                    history[side][cell];
+        }
+        scored.push_back({score, pos});
+    }
+    
+    // Insertion sort: stable, in place, and quick on lists this short
+    for (size_t i = 1; i < scored.size(); i++) {
+        ScoredMove item = scored[i];
+        size_t j = i;
+        for (; j > 0 && scored[j - 1].score < item.score; j--) {
+            scored[j] = scored[j - 1];
+        }
+        scored[j] = item;
+    }
+    for (size_t i = 0; i < scored.size(); i++) {
+        blank_list[i] = scored[i].move;
+    }
+}
+
+// A move that caused a beta cutoff, whatever kind: the table or PV move
+// and fours included, as the same cell often refutes the sibling
+// positions too. Remember it as a killer for this ply and reward it in
+// the history table, more for deeper subtrees
+template <int Cols, int Rows>
+void MinimaxEngine<Cols, Rows>::record_cutoff(bool is_ai, int ply, int depth, const std::pair<int, int>& move) {
+    int cell = cell_index(move.first, move.second);
+    if (killer_moves[ply].first != cell) {
+        killer_moves[ply].second = killer_moves[ply].first;
+        killer_moves[ply].first = cell;
+    }
+    history[is_ai ? 0 : 1][cell] += depth * depth;
+}
+
+// threat_score() for a stone of `side` on `cell`, read through the line table
+template <int Cols, int Rows>
+int MinimaxEngine<Cols, Rows>::threat_estimate(int side, int cell) const {
+    const int* line = &line_cells[cell * 4 * LINE_SPAN];
+    int total = 0;
+    for (int d = 0; d < 4; d++, line += LINE_SPAN) {
+        int cells[LINE_SPAN];
+        for (int k = 0; k < LINE_SPAN; k++) {
+            int c = line[k];
+            if (k == 5 || (c >= 0 && board.has_cell(side, c))) {
+                cells[k] = 1;
+            } else if (c >= 0 && board.has_cell(1 - side, c)) {
+                cells[k] = 2;
+            } else {
+                cells[k] = 0;
+            }
+        }
+        total += centred_window_score(cells);
+    }
+    return total;
+}
+
+// Bitboard::check_win_at() through the line table
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::five_at(int side, int cell) const {
+    const int* line = &line_cells[cell * 4 * LINE_SPAN];
+    for (int d = 0; d < 4; d++, line += LINE_SPAN) {
+        int count = 1;
+        for (int k = 6; k < LINE_SPAN && line[k] >= 0 && board.has_cell(side, line[k]); k++) {
+            count++;
+        }
+        for (int k = 4; k >= 0 && line[k] >= 0 && board.has_cell(side, line[k]); k--) {
+            count++;
+        }
+        if (count >= 5) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// True if the `side` stone on `cell` is part of a four: a five-cell window
+// through it holding four of that side's stones and an empty cell
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::four_at(int side, int cell) const {
+    const int* line = &line_cells[cell * 4 * LINE_SPAN];
+    for (int d = 0; d < 4; d++, line += LINE_SPAN) {
+        for (int start = 1; start <= 5; start++) {
+            int own = 0;
+            int empty = 0;
+            for (int k = start; k < start + 5; k++) {
+                int c = line[k];
+                if (c < 0 || board.has_cell(1 - side, c)) {
+                    break;
+                }
+                if (board.has_cell(side, c)) {
+                    own++;
+                } else {
+                    empty++;
+                }
+            }
+            if (own == 4 && empty == 1) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <int Cols, int Rows>
+int MinimaxEngine<Cols, Rows>::evaluation(bool is_ai) {
+    // Shape scores are kept up to date by make_move/unmake_move
+    int my_score = evaluator.score(is_ai ? 0 : 1);
+    int enemy_score = evaluator.score(is_ai ? 1 : 0);
+    
+    // Total score = My score - Enemy score * ratio * 0.1
+    return my_score - static_cast<int>(enemy_score * ratio * 0.1);
+}
+
+// Five in a row for either side, both checked by one kernel pass
+template <int Cols, int Rows>
+bool MinimaxEngine<Cols, Rows>::game_won() const {
+    return board.fives() != 0;
+}
+
+template class MinimaxEngine<12, 12>;
+template class MinimaxEngine<13, 13>;
+template class MinimaxEngine<15, 15>;
+template class MinimaxEngine<0, 0>;
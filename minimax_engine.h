@@ -0,0 +1,239 @@
+#ifndef MINIMAX_ENGINE_H
+#define MINIMAX_ENGINE_H
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <map>
+#include <string>
+#include <chrono>
+#include <memory>
+#include "bitboard.h"
+#include "evaluator.h"
+#include "transposition_table.h"
+#include "candidate_set.h"
+#include "threat_search.h"
+#include "search_arena.h"
+#include "opening_book.h"
+#include "board_symmetry.h"
+#include "search_options.h"
+
+// Size-independent interface of the search engines, used by the
+// MinimaxAlgorithm dispatcher
+class SearchEngine {
+public:
+    virtual ~SearchEngine() {}
+
+    virtual std::pair<int, int> get_next_move(const std::vector<std::pair<int, int>>& player_pieces,
+                                              const std::vector<std::pair<int, int>>& opponent_pieces) = 0;
+    virtual std::pair<int, int> get_next_move(const std::vector<std::pair<int, int>>& player_pieces,
+                                              const std::vector<std::pair<int, int>>& opponent_pieces,
+                                              std::chrono::milliseconds time_budget) = 0;
+    virtual std::map<std::string, int> get_statistics() const = 0;
+
+    virtual void new_game() = 0;
+    virtual bool apply_move(int player, std::pair<int, int> cell) = 0;
+    virtual bool undo_move() = 0;
+    virtual std::pair<int, int> get_next_move() = 0;
+    virtual std::pair<int, int> get_next_move(std::chrono::milliseconds time_budget) = 0;
+
+    virtual bool load_opening_book(const std::string& path) = 0;
+};
+
+// Per-cell table: a fixed-size array when the cell count is a compile-time
+// constant, a vector sized at construction when it is 0 (runtime size)
+template <typename T, int N>
+struct CellArray {
+    std::array<T, N> data;
+
+    void assign(int, const T& value) { data.fill(value); }
+    T& operator[](int i) { return data[i]; }
+    const T& operator[](int i) const { return data[i]; }
+};
+
+template <typename T>
+struct CellArray<T, 0> {
+    std::vector<T> data;
+
+    void assign(int count, const T& value) { data.assign(count, value); }
+    T& operator[](int i) { return data[i]; }
+    const T& operator[](int i) const { return data[i]; }
+};
+
+// Negamax search with alpha-beta pruning, specialised on the board size.
+// With Cols and Rows fixed the board bounds, cell indexing and the line
+// tables are compile-time constants; MinimaxEngine<0, 0> takes the size
+// at runtime and serves every other board. Explicitly instantiated for
+// 12x12, 13x13, 15x15 and the runtime size in minimax_engine.cpp.
+template <int Cols, int Rows>
+class MinimaxEngine : public SearchEngine {
+    static_assert((Cols > 0) == (Rows > 0), "fix both board dimensions or neither");
+
+public:
+    // See MinimaxAlgorithm for the parameters. board_size must match
+    // Cols x Rows unless both are 0.
+    MinimaxEngine(std::pair<int, int> board_size, int search_depth, double attack_ratio,
+                  std::size_t tt_entries, int thread_count, const SearchOptions& search_options = SearchOptions());
+
+    // Helpers point at the owner's transposition table
+    MinimaxEngine(const MinimaxEngine&) = delete;
+    MinimaxEngine& operator=(const MinimaxEngine&) = delete;
+
+    std::pair<int, int> get_next_move(const std::vector<std::pair<int, int>>& player_pieces,
+                                      const std::vector<std::pair<int, int>>& opponent_pieces) override;
+    std::pair<int, int> get_next_move(const std::vector<std::pair<int, int>>& player_pieces,
+                                      const std::vector<std::pair<int, int>>& opponent_pieces,
+                                      std::chrono::milliseconds time_budget) override;
+    std::map<std::string, int> get_statistics() const override;
+
+    // Game session (see MinimaxAlgorithm)
+    void new_game() override;
+    bool apply_move(int player, std::pair<int, int> cell) override;
+    bool undo_move() override;
+    std::pair<int, int> get_next_move() override;
+    std::pair<int, int> get_next_move(std::chrono::milliseconds time_budget) override;
+
+    bool load_opening_book(const std::string& path) override;
+
+    // threat_score() for a stone of `side` on `cell`, read through the
+    // line table: the move ordering estimate
+    int threat_estimate(int side, int cell) const;
+
+private:
+    // Deepest iteration the time-budgeted search will start
+    static const int MAX_DEPTH = 64;
+    
+    // Most plies a line can gain from four extensions
+    static const int MAX_EXTENSIONS = 4;
+
+    // Cells -5..5 along each of the four directions, per cell
+    static const int LINE_SPAN = 11;
+    static const int CELLS = Cols * Rows;
+
+    // Board dimensions (the runtime ones are only read when Cols is 0)
+    int column_count;
+    int row_count;
+    int DEPTH;
+    double ratio;
+    SearchOptions options;
+
+    int columns() const { return Cols > 0 ? Cols : column_count; }
+    int rows() const { return Rows > 0 ? Rows : row_count; }
+    int cell_count() const { return columns() * rows(); }
+    int cell_index(int x, int y) const { return x * rows() + y; }
+    
+    // Plies a search of `depth` can reach, extensions included
+    int ply_count(int depth) const { return depth + MAX_EXTENSIONS + 1; }
+    
+    // A move stored under position_keys.key(symmetry), the canonical key
+    // being one of them, mapped back to the board's orientation
+    int from_canonical(int symmetry, int cell) const {
+        return cell < 0 ? cell : position_keys.map_cell(inverse_symmetry(symmetry), cell);
+    }
+
+    // Statistics
+    int cut_count;
+    int search_count;
+    int completed_depth;
+    int search_time_ms;
+    int tt_hits;
+    int tt_misses;
+    int tt_stores;
+    int tt_symmetry_moves;
+    int vcf_found;
+    int vcf_length;
+    int vcf_nodes;
+    int vcf_leaf_wins;
+    int pv_reused;
+    int book_hit;
+    int pvs_researches;
+    int aspiration_researches;
+    int reductions;
+    int reduction_researches;
+    int extensions;
+
+    // Iterative deepening state
+    int root_depth;
+    int root_score;                 // score of the last completed iteration
+    bool root_score_valid;          // set once an iteration of this search completed
+    bool time_limited;
+    bool search_aborted;
+    int node_clock;
+    std::chrono::steady_clock::time_point deadline;
+
+    // Principal variation: triangular table filled during the search and
+    // the line from the last completed iteration, tried first next time
+    std::vector<std::vector<std::pair<int, int>>> pv_table;
+    std::vector<int> pv_length;
+    std::vector<std::pair<int, int>> principal_variation;
+    bool follow_pv;
+    
+    // Stones applied since the last search, as (player, cell index), to
+    // match against the start of its principal variation
+    std::vector<std::pair<int, int>> moves_since_search;
+
+    // Move ordering heuristics: two killer moves (cell indices) per ply
+    // and a history score per side and cell, both from beta cutoffs
+    std::vector<std::pair<int, int>> killer_moves;
+    CellArray<int, CELLS> history[2];
+
+    // Line table: for cell c and direction d, entries (c * 4 + d) * 11 ..
+    // hold the cell indices at offsets -5..5 along d, -1 off the board.
+    // Pattern scans walk it instead of bounds-checking coordinates.
+    CellArray<int, CELLS * 4 * LINE_SPAN> line_cells;
+
+    // Game state: AI stones on side 0, opponent stones on side 1
+    Bitboard board;
+    LineEvaluator evaluator;
+    ZobristKeys zobrist;
+    TranspositionTable tt;
+    TranspositionTable* table;      // tt, or the owner's table in a helper
+    SymmetricKeys position_keys;    // Zobrist key under every board symmetry
+    std::vector<std::pair<int, int>> move_history;
+    CandidateSet candidates;        // empty cells next to a stone
+    CandidateSet threat_cells;      // empty cells within 2 of a stone, for fours
+    std::pair<int, int> next_move;
+
+    // Threat-space search: a VCF is looked for before the main search and,
+    // with a small budget, as a quiescence extension at every leaf
+    ThreatSearch threat_search;
+    std::vector<std::pair<int, int>> vcf_line;
+    int vcf_win_score;
+
+    // Opening book, consulted before any search
+    OpeningBook book;
+    
+    // Per-ply move buffers, reused so the search does not allocate
+    SearchArena arena;
+    
+    // Root-parallel search: one helper engine per extra thread
+    int threads;
+    std::vector<std::unique_ptr<MinimaxEngine>> helpers;
+
+    // Algorithm methods
+    void build_line_table();
+    void load_position(const std::vector<std::pair<int, int>>& player_pieces,
+                       const std::vector<std::pair<int, int>>& opponent_pieces);
+    void begin_search();
+    bool search_root(int depth);
+    bool search_root_book();
+    bool search_root_vcf();
+    int search_root_parallel(int depth, int alpha, int beta);
+    void sync_helper(MinimaxEngine& helper) const;
+    bool probe_table(uint64_t key_side, TTEntry& entry, int& tt_move);
+    void generate_moves(bool is_ai, int ply, int tt_move, std::vector<std::pair<int, int>>& blank_list,
+                        std::pair<int, int>& pv_move);
+    void make_move(bool is_ai, const std::pair<int, int>& point);
+    void unmake_move(bool is_ai, const std::pair<int, int>& point);
+    int negamax(bool is_ai, int depth, int ply, int alpha, int beta);
+    int search_move(bool is_ai, const std::pair<int, int>& move, int move_number, int depth, int ply,
+                    int alpha, int beta, bool pv_child);
+    void order_moves(bool is_ai, int ply, int tt_move, int pv_cell, std::vector<std::pair<int, int>>& blank_list);
+    void record_cutoff(bool is_ai, int ply, int depth, const std::pair<int, int>& move);
+    bool five_at(int side, int cell) const;
+    bool four_at(int side, int cell) const;
+    int evaluation(bool is_ai);
+    bool game_won() const;
+};
+
+#endif // MINIMAX_ENGINE_H
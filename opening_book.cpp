@@ -0,0 +1,133 @@
+#include "opening_book.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char BOOK_MAGIC[8] = {'G', 'O', 'B', 'O', 'O', 'K', '0', '1'};
+static const std::size_t HEADER_SIZE = 24;
+static const std::size_t RECORD_SIZE = 12;
+
+// Fixed little-endian fields, independent of the host byte order
+static void put_le(unsigned char* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+static uint64_t get_le(const unsigned char* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        value = value << 8 | in[i];
+    }
+    return value;
+}
+
+bool write_opening_book(const std::string& path, int columns, int rows, std::vector<BookEntry> entries) {
+    // Sort by key, deepest first, and keep one entry per key
+    std::sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key < b.key || (a.key == b.key && a.depth > b.depth);
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [](const BookEntry& a, const BookEntry& b) { return a.key == b.key; }),
+                  entries.end());
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    unsigned char header[HEADER_SIZE];
+    std::memcpy(header, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    put_le(header + 8, static_cast<uint64_t>(columns), 4);
+    put_le(header + 12, static_cast<uint64_t>(rows), 4);
+    put_le(header + 16, entries.size(), 8);
+    bool ok = std::fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE;
+
+    for (const auto& entry : entries) {
+        unsigned char record[RECORD_SIZE];
+        put_le(record, entry.key, 8);
+        put_le(record + 8, entry.move, 2);
+        put_le(record + 10, entry.depth, 2);
+        ok = ok && std::fwrite(record, 1, RECORD_SIZE, file) == RECORD_SIZE;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+OpeningBook::OpeningBook()
+    : mapping(nullptr), mapping_size(0), records(nullptr), entry_count(0), column_count(0), row_count(0) {
+}
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t count = get_le(bytes + 16, 8);
+    if (std::memcmp(bytes, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 ||
+        (size - HEADER_SIZE) / RECORD_SIZE != count || (size - HEADER_SIZE) % RECORD_SIZE != 0) {
+        munmap(data, size);
+        return false;
+    }
+
+    mapping = data;
+    mapping_size = size;
+    records = bytes + HEADER_SIZE;
+    entry_count = static_cast<std::size_t>(count);
+    column_count = static_cast<int>(get_le(bytes + 8, 4));
+    row_count = static_cast<int>(get_le(bytes + 12, 4));
+    return true;
+}
+
+void OpeningBook::close() {
+    if (mapping) {
+        munmap(mapping, mapping_size);
+    }
+    mapping = nullptr;
+    mapping_size = 0;
+    records = nullptr;
+    entry_count = 0;
+    column_count = 0;
+    row_count = 0;
+}
+
+bool OpeningBook::probe(uint64_t key, BookEntry& entry) const {
+    std::size_t low = 0;
+    std::size_t high = entry_count;
+    while (low < high) {
+        std::size_t mid = low + (high - low) / 2;
+        const unsigned char* record = records + mid * RECORD_SIZE;
+        uint64_t mid_key = get_le(record, 8);
+        if (mid_key < key) {
+            low = mid + 1;
+        } else if (mid_key > key) {
+            high = mid;
+        } else {
+            entry.key = mid_key;
+            entry.move = static_cast<uint16_t>(get_le(record + 8, 2));
+            entry.depth = static_cast<uint16_t>(get_le(record + 10, 2));
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// One book position: canonical Zobrist key (board_symmetry.h, side to
+// move as side 0) and the best move as a cell index in the canonical
+// orientation, with the depth it was searched to
+struct BookEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t depth;
+};
+
+// Write a book file: a 24-byte header ("GOBOOK01", uint32 columns, uint32
+// rows, uint64 entry count) then 12-byte records (key, move, depth) sorted
+// by key, all little-endian. Entries with the same key keep the deepest.
+bool write_opening_book(const std::string& path, int columns, int rows, std::vector<BookEntry> entries);
+
+// Read-only opening book. The file is memory-mapped and searched in place
+// by binary search, so opening it reads nothing up front and uses no heap
+// memory however large the book is.
+class OpeningBook {
+public:
+    OpeningBook();
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    // Map `path`; false (and no book) if it is missing or malformed
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return records != nullptr; }
+    int columns() const { return column_count; }
+    int rows() const { return row_count; }
+    std::size_t size() const { return entry_count; }
+
+    // True and fills `entry` if `key` is in the book
+    bool probe(uint64_t key, BookEntry& entry) const;
+
+private:
+    void* mapping;
+    std::size_t mapping_size;
+    const unsigned char* records;
+    std::size_t entry_count;
+    int column_count;
+    int row_count;
+};
+
+#endif // OPENING_BOOK_H
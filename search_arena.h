@@ -0,0 +1,42 @@
+#ifndef SEARCH_ARENA_H
+#define SEARCH_ARENA_H
+
+#include <vector>
+#include <utility>
+
+// A candidate move with its ordering score
+struct ScoredMove {
+    long long score;
+    std::pair<int, int> move;
+};
+
+// Scratch memory for the search, owned by the engine and reused by every
+// get_next_move call. Each ply gets its own move list and ordering buffer,
+// reserved to the board's cell count, so once the arena has grown to the
+// deepest ply searched the node loop never allocates.
+class SearchArena {
+public:
+    struct Ply {
+        std::vector<std::pair<int, int>> moves;
+        std::vector<ScoredMove> scored;
+    };
+
+    // Make sure plies 0 .. ply_count - 1 exist with room for `cells` moves;
+    // cheap when they already do
+    void reserve(int ply_count, int cells) {
+        if (static_cast<int>(plies.size()) < ply_count) {
+            plies.resize(ply_count);
+        }
+        for (auto& ply : plies) {
+            ply.moves.reserve(cells);
+            ply.scored.reserve(cells);
+        }
+    }
+
+    Ply& ply(int index) { return plies[index]; }
+
+private:
+    std::vector<Ply> plies;
+};
+
+#endif // SEARCH_ARENA_H
@@ -0,0 +1,42 @@
+#ifndef SEARCH_OPTIONS_H
+#define SEARCH_OPTIONS_H
+
+// Search algorithm switches, fixed when the engine is constructed. With
+// the defaults the search is plain fail-hard alpha-beta at the fixed
+// depth; gobang_search_bench compares the settings on a set of positions.
+struct SearchOptions {
+    // Principal variation search (NegaScout): after the first move, each
+    // move is searched with a null window around alpha and searched again
+    // with the full window only if it turns out better
+    bool principal_variation_search = false;
+
+    // Aspiration windows: each iterative deepening iteration after the
+    // first searches the root with a window of +-aspiration_window around
+    // the previous iteration's score, and again with that side opened
+    // when the score falls outside it
+    bool aspiration_windows = false;
+    int aspiration_window = 2500;
+
+    // Late move reductions: at nodes of at least reduction_min_depth,
+    // moves from the reduction_move_count-th on in the search order that
+    // do not make a four are searched a ply shallower first, and fully
+    // only if they beat alpha there
+    bool late_move_reductions = false;
+    int reduction_move_count = 6;
+    int reduction_min_depth = 3;
+
+    // Below the root, search only the candidate_limit best candidates in
+    // the move order (own and blocked shape plus history)
+    bool candidate_cap = false;
+    int candidate_limit = 12;
+
+    // Search a move that makes a four one ply deeper: the reply is forced,
+    // so the line costs little and threats show up within the depth
+    bool four_extensions = false;
+
+    // Reach the fixed depth by iterative deepening (depth 1, 2, ...) as
+    // the time-budgeted search does, instead of searching it directly
+    bool iterative_deepening = false;
+};
+
+#endif // SEARCH_OPTIONS_H
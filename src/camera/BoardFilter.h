@@ -0,0 +1,128 @@
+#ifndef BOARD_FILTER_H
+#define BOARD_FILTER_H
+
+#include <algorithm>
+#include <vector>
+
+// A change of one intersection in the stable board: before/after are
+// 0 empty, 1 black, 2 white. A new stone has before == 0
+struct BoardEvent {
+    int row;
+    int col;
+    int before;
+    int after;
+
+    bool isNewStone() const { return before == 0 && after != 0; }
+};
+
+// Temporal filter over the per-frame boards of the classifier. Each cell
+// keeps a vote over its last `window` readings and its stable value only
+// changes once `agree` of them name the same new value, so a flicker
+// shorter than that never reaches the stable board.
+//
+// A hand or a shadow over the board changes many cells at once, while a
+// move changes one: a frame that differs from the stable board in more
+// than maxChanged cells is taken as occluded and not counted at all. A
+// hand moves, though, while a new game or a swapped board is a still
+// scene that differs: once the differing frames have all been identical
+// for resyncFrames in a row, the stable board is reset to them, so the
+// filter cannot lock up. Stones already on the board when the camera
+// starts are picked up the same way.
+class BoardFilter {
+public:
+    BoardFilter(int gridLines, int window = 8, int agree = 6, int maxChanged = 4, int resyncFrames = 30)
+        : lines_(gridLines), window_(window), agree_(agree), maxChanged_(maxChanged), resyncFrames_(resyncFrames),
+          stable_(gridLines, std::vector<int>(gridLines, 0)),
+          history_(gridLines * gridLines * window, 0),
+          votes_(gridLines * gridLines * 3, 0) {
+        // Every cell starts with a full window of "empty" readings
+        for (int cell = 0; cell < lines_ * lines_; ++cell) votes_[cell * 3] = window_;
+    }
+
+    // Count one frame's board. Returns the cells whose stable value
+    // changed with it, usually none
+    const std::vector<BoardEvent>& update(const std::vector<std::vector<int>>& board) {
+        events_.clear();
+
+        int changed = 0;
+        for (int row = 0; row < lines_; ++row) {
+            for (int col = 0; col < lines_; ++col) {
+                if (board[row][col] != stable_[row][col]) changed++;
+            }
+        }
+        if (changed > maxChanged_) {
+            if (board == still_) {
+                stillFrames_++;
+            } else {
+                still_ = board;
+                stillFrames_ = 1;
+            }
+            if (stillFrames_ < resyncFrames_) {
+                rejected_++;
+                return events_;
+            }
+            resync(board);
+            return events_;
+        }
+        stillFrames_ = 0;
+
+        for (int row = 0; row < lines_; ++row) {
+            for (int col = 0; col < lines_; ++col) {
+                int cell = row * lines_ + col;
+                int& slot = history_[cell * window_ + next_];
+                votes_[cell * 3 + slot]--;
+                slot = board[row][col];
+                votes_[cell * 3 + slot]++;
+
+                int value = board[row][col];
+                if (value != stable_[row][col] && votes_[cell * 3 + value] >= agree_) {
+                    events_.push_back({row, col, stable_[row][col], value});
+                    stable_[row][col] = value;
+                }
+            }
+        }
+        next_ = (next_ + 1) % window_;
+        return events_;
+    }
+
+    // The filtered board
+    const std::vector<std::vector<int>>& stable() const { return stable_; }
+
+    // Frames discarded as occluded, for reporting
+    long rejectedFrames() const { return rejected_; }
+
+private:
+    int lines_;
+    int window_;
+    int agree_;
+    int maxChanged_;
+    int resyncFrames_;
+    int next_ = 0;                      // history slot the next frame overwrites
+    long rejected_ = 0;
+    std::vector<std::vector<int>> stable_;
+    std::vector<int> history_;          // per cell, the last `window` readings
+    std::vector<int> votes_;            // per cell, readings of each value in the window
+    std::vector<std::vector<int>> still_;   // the last occluded frame
+    int stillFrames_ = 0;               // occluded frames in a row identical to it
+    std::vector<BoardEvent> events_;
+
+    // Take board as the stable board, every reading in the window with it
+    void resync(const std::vector<std::vector<int>>& board) {
+        for (int row = 0; row < lines_; ++row) {
+            for (int col = 0; col < lines_; ++col) {
+                int cell = row * lines_ + col;
+                int value = board[row][col];
+                std::fill(history_.begin() + cell * window_, history_.begin() + (cell + 1) * window_, value);
+                std::fill(votes_.begin() + cell * 3, votes_.begin() + cell * 3 + 3, 0);
+                votes_[cell * 3 + value] = window_;
+                if (value != stable_[row][col]) {
+                    events_.push_back({row, col, stable_[row][col], value});
+                    stable_[row][col] = value;
+                }
+            }
+        }
+        stillFrames_ = 0;
+    }
+};
+
+#endif // BOARD_FILTER_H
@@ -0,0 +1,147 @@
+#ifndef BOARD_TRACKER_H
+#define BOARD_TRACKER_H
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Keeps the board quad from one frame to the next. The board barely
+// moves, so instead of Canny + findContours + approxPolyDP on every
+// frame the tracker refines the last four corners with cornerSubPix in
+// a small window around each and accepts them if they stayed put. Only
+// when that check fails (board moved, corner occluded) or every
+// recheckInterval frames does it run the full contour detection again.
+//
+// Corners that moved less than half a pixel are left as they were, so
+// the warp tables built from them (see BoardWarp) stay valid.
+class BoardTracker {
+public:
+    explicit BoardTracker(int recheckInterval = 120) : recheckInterval_(recheckInterval) {}
+
+    // Locate the board in a greyscale frame. False when there is no board
+    bool locate(const cv::Mat& gray) {
+        if (valid_ && framesSinceDetection_ < recheckInterval_ && track(gray)) {
+            tracked_.fetch_add(1, std::memory_order_relaxed);
+            framesSinceDetection_++;
+            return true;
+        }
+        valid_ = detect(gray);
+        framesSinceDetection_ = 0;
+        if (valid_) detections_.fetch_add(1, std::memory_order_relaxed);
+        return valid_;
+    }
+
+    // Corners in the frame: top-left, top-right, bottom-right, bottom-left
+    const std::vector<cv::Point2f>& corners() const { return corners_; }
+
+    // Frames located by tracking / by full detection, for reporting
+    uint64_t trackedFrames() const { return tracked_.load(std::memory_order_relaxed); }
+    uint64_t fullDetections() const { return detections_.load(std::memory_order_relaxed); }
+
+private:
+    // A tracked corner may drift this far (px) per frame before the
+    // board is considered moved and detected again; moves below
+    // STILL_PX are noise and leave the corners unchanged
+    static constexpr float MAX_DRIFT_PX = 4.0f;
+    static constexpr float STILL_PX = 0.5f;
+    static constexpr int CORNER_WINDOW = 7;
+
+    int recheckInterval_;
+    bool valid_ = false;
+    int framesSinceDetection_ = 0;
+    double detectedArea_ = 0;
+    std::vector<cv::Point2f> corners_;
+    std::atomic<uint64_t> tracked_{0};
+    std::atomic<uint64_t> detections_{0};
+
+    // Refine the previous corners; false if any left its window or the
+    // quad changed shape
+    bool track(const cv::Mat& gray) {
+        std::vector<cv::Point2f> refined = corners_;
+        for (const auto& p : refined) {
+            if (p.x < CORNER_WINDOW || p.y < CORNER_WINDOW ||
+                p.x >= gray.cols - CORNER_WINDOW || p.y >= gray.rows - CORNER_WINDOW) return false;
+        }
+        cornerSubPix(gray, refined, cv::Size(CORNER_WINDOW, CORNER_WINDOW), cv::Size(-1, -1),
+                     cv::TermCriteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 10, 0.05));
+
+        float largestMove = 0;
+        for (int i = 0; i < 4; ++i) {
+            cv::Point2f d = refined[i] - corners_[i];
+            largestMove = std::max(largestMove, std::sqrt(d.x * d.x + d.y * d.y));
+        }
+        if (largestMove > MAX_DRIFT_PX) return false;
+
+        // A corner sliding along an edge keeps its window but shrinks or
+        // stretches the quad
+        double area = quadArea(refined);
+        if (std::abs(area - detectedArea_) > detectedArea_ * 0.05) return false;
+
+        if (largestMove > STILL_PX) corners_ = refined;
+        return true;
+    }
+
+    // Full detection: the largest contour, if it approximates to a quad
+    bool detect(const cv::Mat& gray) {
+        cv::Mat blurred, edges;
+        GaussianBlur(gray, blurred, cv::Size(7, 7), 0);
+        Canny(blurred, edges, 50, 150);
+
+        std::vector<std::vector<cv::Point>> contours;
+        findContours(edges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        if (contours.empty()) return false;
+
+        // Only the largest one is used: one pass instead of a sort
+        size_t largest = 0;
+        double largestArea = -1;
+        for (size_t i = 0; i < contours.size(); ++i) {
+            double area = contourArea(contours[i]);
+            if (area > largestArea) {
+                largestArea = area;
+                largest = i;
+            }
+        }
+
+        std::vector<cv::Point> approx;
+        approxPolyDP(contours[largest], approx, arcLength(contours[largest], true) * 0.02, true);
+        if (approx.size() != 4) return false;
+
+        std::vector<cv::Point2f> found = orderCorners(approx);
+        cornerSubPix(gray, found, cv::Size(CORNER_WINDOW, CORNER_WINDOW), cv::Size(-1, -1),
+                     cv::TermCriteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 20, 0.03));
+        detectedArea_ = quadArea(found);
+        corners_ = found;
+        return true;
+    }
+
+    // Order 4 corner points (top-left, top-right, bottom-right, bottom-left).
+    // Top-right has the smallest y - x, bottom-left the largest
+    static std::vector<cv::Point2f> orderCorners(const std::vector<cv::Point>& pts) {
+        std::vector<cv::Point2f> rect(4);
+        float s[4], d[4];
+        for (int i = 0; i < 4; ++i) {
+            s[i] = pts[i].x + pts[i].y;
+            d[i] = pts[i].y - pts[i].x;
+        }
+        rect[0] = pts[std::min_element(s, s + 4) - s]; // top-left
+        rect[2] = pts[std::max_element(s, s + 4) - s]; // bottom-right
+        rect[1] = pts[std::min_element(d, d + 4) - d]; // top-right
+        rect[3] = pts[std::max_element(d, d + 4) - d]; // bottom-left
+        return rect;
+    }
+
+    static double quadArea(const std::vector<cv::Point2f>& q) {
+        double twice = 0;
+        for (int i = 0; i < 4; ++i) {
+            const cv::Point2f& a = q[i];
+            const cv::Point2f& b = q[(i + 1) % 4];
+            twice += a.x * b.y - b.x * a.y;
+        }
+        return std::abs(twice) / 2;
+    }
+};
+
+#endif // BOARD_TRACKER_H
@@ -0,0 +1,127 @@
+#ifndef BOARD_WARP_H
+#define BOARD_WARP_H
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Perspective warp of the board to a square greyscale image through
+// precomputed fixed-point remap tables. The tables are built once per
+// homography (initUndistortRectifyMap with identity intrinsics and the
+// homography as the rectification transform gives exactly the inverse
+// mapping warpPerspective computes per pixel), and the warp then reads
+// only the grey channel and writes into the caller's buffer, which is
+// not reallocated once it has the board size.
+//
+// With enablePatches the warp can also produce just the squares around
+// the grid intersections, tiled into a small image, for a classifier
+// that reads nothing else (see GridClassifier).
+class BoardWarp {
+public:
+    explicit BoardWarp(int boardPixelSize) : size_(boardPixelSize) {}
+
+    // Point the warp at a board quad (top-left, top-right, bottom-right,
+    // bottom-left). The tables are rebuilt only if a corner moved more
+    // than half a pixel since the last build; returns true if they were.
+    // The corners must be sub-pixel (BoardTracker, cornerSubPix): the
+    // integer vertices of approxPolyDP jump a pixel between frames
+    bool update(const std::vector<cv::Point2f>& corners) {
+        if (!corners_.empty()) {
+            float largestMove = 0;
+            for (int i = 0; i < 4; ++i) {
+                cv::Point2f d = corners[i] - corners_[i];
+                largestMove = std::max(largestMove, std::sqrt(d.x * d.x + d.y * d.y));
+            }
+            if (largestMove <= STILL_PX) return false;
+        }
+
+        corners_ = corners;
+        std::vector<cv::Point2f> target = {
+            cv::Point2f(0, 0), cv::Point2f(size_ - 1, 0),
+            cv::Point2f(size_ - 1, size_ - 1), cv::Point2f(0, size_ - 1)
+        };
+        homography_ = getPerspectiveTransform(corners_, target);
+        initUndistortRectifyMap(cv::Mat::eye(3, 3, CV_64F), cv::Mat(), homography_, cv::Mat::eye(3, 3, CV_64F),
+                                cv::Size(size_, size_), CV_16SC2, map1_, map2_);
+        if (patchLines_ > 0) buildPatchMaps();
+        rebuilds_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool ready() const { return !map1_.empty(); }
+
+    // Frame-to-board perspective transform of the current tables
+    const cv::Mat& homography() const { return homography_; }
+
+    // Warp a greyscale frame into out (CV_8UC1, board size x board size)
+    void warp(const cv::Mat& gray, cv::Mat& out) const {
+        out.create(size_, size_, CV_8UC1);
+        remap(gray, out, map1_, map2_, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+    }
+
+    // Sample a patchSize square around each of the gridLines x gridLines
+    // intersections (spacing pixels apart on the full warp, the first at
+    // 0, 0). Takes effect from the next table build
+    void enablePatches(int gridLines, float spacing, int patchSize) {
+        patchLines_ = gridLines;
+        patchSpacing_ = spacing;
+        patchSize_ = patchSize;
+        corners_.clear();
+    }
+
+    // Warp only the patches: tile (row, col) of out is the square centred
+    // on that intersection, so it sits at (col, row) * patchSize and its
+    // centre at patchSize / 2 within the tile
+    void warpPatches(const cv::Mat& gray, cv::Mat& out) const {
+        out.create(patchLines_ * patchSize_, patchLines_ * patchSize_, CV_8UC1);
+        remap(gray, out, patchMap1_, patchMap2_, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+    }
+
+    // Times the tables were built, for reporting
+    uint64_t rebuilds() const { return rebuilds_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr float STILL_PX = 0.5f;
+
+    int size_;
+    std::atomic<uint64_t> rebuilds_{0};
+    std::vector<cv::Point2f> corners_;
+    cv::Mat homography_;
+    cv::Mat map1_;                      // CV_16SC2: integer source pixel
+    cv::Mat map2_;                      // CV_16UC1: index into the bilinear weight table
+    int patchLines_ = 0;
+    float patchSpacing_ = 0;
+    int patchSize_ = 0;
+    cv::Mat patchMapX_, patchMapY_;     // float tables, kept to avoid reallocating
+    cv::Mat patchMap1_, patchMap2_;
+
+    // Board pixels outside the board (half of each edge patch) are
+    // clamped to its edge rather than read from the table around it
+    void buildPatchMaps() {
+        int side = patchLines_ * patchSize_;
+        int half = patchSize_ / 2;
+        cv::Mat inverse = homography_.inv();
+        const double* h = inverse.ptr<double>();
+        patchMapX_.create(side, side, CV_32FC1);
+        patchMapY_.create(side, side, CV_32FC1);
+        for (int v = 0; v < side; ++v) {
+            float* xs = patchMapX_.ptr<float>(v);
+            float* ys = patchMapY_.ptr<float>(v);
+            double by = (v / patchSize_) * patchSpacing_ + (v % patchSize_) - half;
+            by = std::min(std::max(by, 0.0), double(size_ - 1));
+            for (int u = 0; u < side; ++u) {
+                double bx = (u / patchSize_) * patchSpacing_ + (u % patchSize_) - half;
+                bx = std::min(std::max(bx, 0.0), double(size_ - 1));
+                double w = h[6] * bx + h[7] * by + h[8];
+                xs[u] = float((h[0] * bx + h[1] * by + h[2]) / w);
+                ys[u] = float((h[3] * bx + h[4] * by + h[5]) / w);
+            }
+        }
+        convertMaps(patchMapX_, patchMapY_, patchMap1_, patchMap2_, CV_16SC2);
+    }
+};
+
+#endif // BOARD_WARP_H
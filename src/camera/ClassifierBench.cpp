@@ -0,0 +1,187 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "BoardTracker.h"
+#include "BoardWarp.h"
+#include "GridClassifier.h"
+
+using namespace cv;
+using namespace std;
+
+/**
+ * Compares the piece detectors on recorded camera frames, for speed and
+ * for accuracy:
+ *   hough    full grey warp, GaussianBlur, HoughCircles and a mask mean
+ *            per circle (the detector GomokuCam4 used)
+ *   grid     full grey warp and GridClassifier over the 169 intersections
+ *   patches  BoardWarp::warpPatches and GridClassifier over the patches
+ *
+ * Each FRAME is a raw capture of the board (e.g. saved with imwrite from
+ * the camera loop). If FRAME.txt exists next to it (the image extension
+ * replaced), it holds the true board as 13 lines of 13 characters:
+ * '.' empty, 'B' or 'X' black, 'W' or 'O' white, and accuracy is scored
+ * against it; otherwise only the timings are reported. Localisation runs
+ * once per frame, always a full detection, and is not timed.
+ *
+ * Usage: ClassifierBench [--repeat=N] FRAME...
+ *
+ * Built with the camera programs by CMake when OpenCV is found.
+ */
+
+// Configuration, as in GomokuCam4
+const int GRID_SIZE = 13;
+const int BOARD_PIXEL_SIZE = 600;
+const float GRID_PIXEL_SPACING = BOARD_PIXEL_SIZE / (float)(GRID_SIZE - 1);
+const int STONE_SAMPLE_RADIUS = 15;
+const int PATCH_SIZE = 2 * STONE_SAMPLE_RADIUS + 1;
+
+typedef vector<vector<int>> Board;
+
+struct MethodResult {
+    string name;
+    double totalMs = 0;
+    long runs = 0;
+    long correct = 0;       // cells matching the label
+    long missed = 0;        // stone labelled, empty reported
+    long falseStones = 0;   // empty labelled, stone reported
+    long wrongColour = 0;
+};
+
+// The Hough path: circles on the blurred board, each coloured by the
+// mean of a mask drawn over the whole image
+void houghDetect(const Mat& grayWarped, Board& board) {
+    board.assign(GRID_SIZE, vector<int>(GRID_SIZE, 0));
+    Mat blurred;
+    GaussianBlur(grayWarped, blurred, Size(5, 5), 0);
+
+    vector<Vec3f> circles;
+    HoughCircles(blurred, circles, HOUGH_GRADIENT, 1.2, GRID_PIXEL_SPACING * 0.8,
+                 100, 18, 18, 24);
+
+    for (auto c : circles) {
+        int x = cvRound(c[0]), y = cvRound(c[1]), r = cvRound(c[2]);
+        int row = round(y / GRID_PIXEL_SPACING);
+        int col = round(x / GRID_PIXEL_SPACING);
+        if (row < 0 || row >= GRID_SIZE || col < 0 || col >= GRID_SIZE) continue;
+
+        Mat mask = Mat::zeros(grayWarped.size(), CV_8UC1);
+        circle(mask, Point(x, y), int(r * 0.7), Scalar(255), -1);
+        board[row][col] = mean(grayWarped, mask)[0] < 80 ? 1 : 2;
+    }
+}
+
+// Label file of a frame: its path with the extension replaced by .txt
+bool loadLabel(const string& framePath, Board& label) {
+    size_t dot = framePath.find_last_of('.');
+    ifstream file((dot == string::npos ? framePath : framePath.substr(0, dot)) + ".txt");
+    if (!file) return false;
+
+    label.assign(GRID_SIZE, vector<int>(GRID_SIZE, 0));
+    string line;
+    for (int row = 0; row < GRID_SIZE; ++row) {
+        if (!getline(file, line) || (int)line.size() < GRID_SIZE) return false;
+        for (int col = 0; col < GRID_SIZE; ++col) {
+            char c = line[col];
+            label[row][col] = (c == 'B' || c == 'X') ? 1 : (c == 'W' || c == 'O') ? 2 : 0;
+        }
+    }
+    return true;
+}
+
+void score(const Board& found, const Board& label, MethodResult& result) {
+    for (int row = 0; row < GRID_SIZE; ++row) {
+        for (int col = 0; col < GRID_SIZE; ++col) {
+            int f = found[row][col], l = label[row][col];
+            if (f == l) result.correct++;
+            else if (f == 0) result.missed++;
+            else if (l == 0) result.falseStones++;
+            else result.wrongColour++;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int repeat = 20;
+    vector<string> frames;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--repeat=", 0) == 0) repeat = max(1, atoi(arg.c_str() + 9));
+        else frames.push_back(arg);
+    }
+    if (frames.empty()) {
+        cerr << "Usage: " << argv[0] << " [--repeat=N] FRAME..." << endl;
+        return 1;
+    }
+
+    BoardWarp boardWarp(BOARD_PIXEL_SIZE);
+    boardWarp.enablePatches(GRID_SIZE, GRID_PIXEL_SPACING, PATCH_SIZE);
+    GridClassifier gridClassifier(GRID_SIZE, 0, GRID_PIXEL_SPACING, STONE_SAMPLE_RADIUS);
+    GridClassifier patchClassifier(GRID_SIZE, PATCH_SIZE / 2, PATCH_SIZE, STONE_SAMPLE_RADIUS);
+
+    vector<MethodResult> results(3);
+    results[0].name = "hough";
+    results[1].name = "grid";
+    results[2].name = "patches";
+    int used = 0, labelled = 0, unlocated = 0;
+    Mat gray, warped, patches;
+    Board board;
+
+    for (const string& path : frames) {
+        Mat frame = imread(path);
+        if (frame.empty()) {
+            cerr << "Cannot read " << path << endl;
+            continue;
+        }
+        cvtColor(frame, gray, COLOR_BGR2GRAY);
+        BoardTracker tracker;           // fresh per frame: the frames are unrelated, nothing to track from
+        if (!tracker.locate(gray)) {
+            unlocated++;
+            continue;
+        }
+        boardWarp.update(tracker.corners());
+        used++;
+
+        Board label;
+        bool hasLabel = loadLabel(path, label);
+        if (hasLabel) labelled++;
+
+        for (int method = 0; method < 3; ++method) {
+            auto start = chrono::steady_clock::now();
+            for (int r = 0; r < repeat; ++r) {
+                if (method == 2) {
+                    boardWarp.warpPatches(gray, patches);
+                    patchClassifier.classify(patches, board);
+                } else {
+                    boardWarp.warp(gray, warped);
+                    if (method == 0) houghDetect(warped, board);
+                    else gridClassifier.classify(warped, board);
+                }
+            }
+            auto end = chrono::steady_clock::now();
+            results[method].totalMs += chrono::duration<double, milli>(end - start).count();
+            results[method].runs += repeat;
+            if (hasLabel) score(board, label, results[method]);
+        }
+    }
+
+    cout << used << " frames (" << labelled << " labelled, " << unlocated << " without a board found), "
+         << repeat << " runs each" << endl;
+    cout << left << setw(10) << "method" << right << setw(12) << "ms/frame" << setw(12) << "accuracy"
+         << setw(10) << "missed" << setw(10) << "false" << setw(10) << "colour" << endl;
+    for (const auto& r : results) {
+        cout << left << setw(10) << r.name << right << fixed << setprecision(3)
+             << setw(12) << (r.runs > 0 ? r.totalMs / r.runs : 0.0);
+        if (labelled > 0) {
+            double cells = double(labelled) * GRID_SIZE * GRID_SIZE;
+            cout << setw(11) << setprecision(2) << 100.0 * r.correct / cells << "%"
+                 << setw(10) << r.missed << setw(10) << r.falseStones << setw(10) << r.wrongColour;
+        }
+        cout << endl;
+    }
+    return used > 0 ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Building blocks for the threaded camera loop: each stage (capture,
+// board localisation, piece detection, decision) runs on its own thread
+// and hands its output to the next through a Mailbox, or through an
+// EventQueue where nothing may be lost.
+
+using PipelineClock = std::chrono::steady_clock;
+
+// Single-value mailbox for exactly one producer and one consumer thread,
+// which only ever want the newest value: a stage never waits for a slower
+// one downstream. put replaces a value not yet taken, so the consumer
+// always gets the latest one. It is a triple buffer: the producer fills
+// one slot, the consumer reads another and the third holds the latest
+// value, and put and take swap values in and out rather than copy them,
+// so the buffers inside T (a cv::Mat's pixels) circulate between the two
+// threads instead of being reallocated.
+template <typename T>
+class Mailbox {
+public:
+    // Producer side. Publishes item; item receives an older value back,
+    // whose buffers the consumer is done with and can be refilled
+    void put(T& item) {
+        std::swap(slots_[back_], item);
+        int previous = latest_.exchange(back_ | FRESH, std::memory_order_acq_rel);
+        if (previous & FRESH) overwritten_.fetch_add(1, std::memory_order_relaxed);
+        back_ = previous & ~FRESH;
+    }
+
+    // Consumer side. Takes the latest value, handing back the one item
+    // held; false, leaving item untouched, if nothing new was put
+    bool take(T& item) {
+        if (!(latest_.load(std::memory_order_relaxed) & FRESH)) return false;
+        front_ = latest_.exchange(front_, std::memory_order_acq_rel) & ~FRESH;
+        std::swap(slots_[front_], item);
+        return true;
+    }
+
+    // Values replaced before the consumer took them
+    uint64_t dropped() const { return overwritten_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int FRESH = 4;     // flag on latest_: put since the last take
+
+    T slots_[3];
+    int back_ = 0;                      // producer's slot
+    int front_ = 1;                     // consumer's slot
+    alignas(64) std::atomic<int> latest_{2};
+    std::atomic<uint64_t> overwritten_{0};
+};
+
+// Bounded lock-free FIFO for exactly one producer and one consumer thread,
+// for items that must all arrive in order (board events). tryPush fails
+// when the queue is full, and the producer keeps the item to push again.
+// Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class EventQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side. Returns false, leaving item untouched, when full
+    bool tryPush(T&& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity) return false;
+        slots_[head & (Capacity - 1)] = std::move(item);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Takes the oldest item; false when empty
+    bool tryPop(T& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        item = std::move(slots_[tail & (Capacity - 1)]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T slots_[Capacity];
+    alignas(64) std::atomic<size_t> head_{0};   // written by the producer
+    alignas(64) std::atomic<size_t> tail_{0};   // written by the consumer
+};
+
+// Per-stage counters, written by the stage thread and read by the
+// reporting thread. Latencies are accumulated in microseconds.
+struct StageStats {
+    std::atomic<uint64_t> items{0};
+    std::atomic<uint64_t> busyUs{0};
+    std::atomic<uint64_t> maxUs{0};
+
+    void record(PipelineClock::time_point start, PipelineClock::time_point end) {
+        uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        items.fetch_add(1, std::memory_order_relaxed);
+        busyUs.fetch_add(us, std::memory_order_relaxed);
+        uint64_t previous = maxUs.load(std::memory_order_relaxed);
+        while (us > previous && !maxUs.compare_exchange_weak(previous, us, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+// Periodic report of one stage: rate and mean / worst latency since
+// the previous report
+class StageReport {
+public:
+    explicit StageReport(const char* name) : name_(name) {}
+
+    std::string line(StageStats& stats, double seconds) {
+        uint64_t items = stats.items.load(std::memory_order_relaxed);
+        uint64_t busy = stats.busyUs.load(std::memory_order_relaxed);
+        uint64_t worst = stats.maxUs.exchange(0, std::memory_order_relaxed);
+        uint64_t count = items - lastItems_;
+        double meanMs = count > 0 ? (busy - lastBusy_) / 1000.0 / count : 0.0;
+        lastItems_ = items;
+        lastBusy_ = busy;
+
+        char text[128];
+        snprintf(text, sizeof(text), "%s %5.1f fps %6.2f ms (max %6.2f)", name_,
+                 seconds > 0 ? count / seconds : 0.0, meanMs, worst / 1000.0);
+        return text;
+    }
+
+private:
+    const char* name_;
+    uint64_t lastItems_ = 0;
+    uint64_t lastBusy_ = 0;
+};
+
+// Consumer-side wait for a new value. Neither queue blocks, so an idle
+// stage polls with a short sleep; returns false once stopped
+template <typename T>
+bool waitLatest(Mailbox<T>& mailbox, T& item, const std::atomic<bool>& running) {
+    while (running.load(std::memory_order_relaxed)) {
+        if (mailbox.take(item)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+// Same for events: takes the oldest
+template <typename T, size_t Capacity>
+bool waitNext(EventQueue<T, Capacity>& queue, T& item, const std::atomic<bool>& running) {
+    while (running.load(std::memory_order_relaxed)) {
+        if (queue.tryPop(item)) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+#endif // FRAME_PIPELINE_H
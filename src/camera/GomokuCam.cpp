@@ -1,13 +1,14 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
+#include "BoardWarp.h"
+#include "BoardFilter.h"
 
 using namespace cv;
 using namespace std;
 
 // 棋盘角点检测（基于轮廓）
-vector<Point2f> detect_board_corners_by_contour(const Mat& frame) {
-    Mat gray, blurImg, edges;
-    cvtColor(frame, gray, COLOR_BGR2GRAY);
+vector<Point2f> detect_board_corners_by_contour(const Mat& gray) {
+    Mat blurImg, edges;
     GaussianBlur(gray, blurImg, Size(5, 5), 0);
     Canny(blurImg, edges, 50, 150);
 
@@ -24,6 +25,9 @@ vector<Point2f> detect_board_corners_by_contour(const Mat& frame) {
             vector<Point2f> corners;
             for (const Point& p : approx)
                 corners.push_back(p);
+            // approxPolyDP 的整数角点逐帧抖动 1 像素，会让映射表反复重建；亚像素精修后才稳定
+            cornerSubPix(gray, corners, Size(7, 7), Size(-1, -1),
+                         TermCriteria(TermCriteria::COUNT + TermCriteria::EPS, 20, 0.03));
             return corners;
         }
     }
@@ -45,21 +49,14 @@ vector<Point2f> order_points(const vector<Point2f>& pts) {
     return ordered;
 }
 
-// 透视变换拉直
-Mat warp_board(const Mat& frame, const vector<Point2f>& corners, int size = 480) {
-    vector<Point2f> src = order_points(corners);
-    vector<Point2f> dst = { {0,0}, {float(size),0}, {float(size),float(size)}, {0,float(size)} };
-    Mat M = getPerspectiveTransform(src, dst);
-    Mat warped;
-    warpPerspective(frame, warped, M, Size(size, size));
-    return warped;
+// 透视变换拉直（只处理灰度图；定点映射表仅在角点移动时重建，输出写入预分配的 warped）
+void warp_board(const Mat& gray, const vector<Point2f>& corners, BoardWarp& board_warp, Mat& warped) {
+    board_warp.update(order_points(corners));
+    board_warp.warp(gray, warped);
 }
 
 // 灰度均值识别棋盘状态
-vector<vector<int>> extract_board_state_gray_based(const Mat& warped, int board_size = 12) {
-    Mat gray;
-    cvtColor(warped, gray, COLOR_BGR2GRAY);
-
+vector<vector<int>> extract_board_state_gray_based(const Mat& gray, int board_size = 12) {
     int h = gray.rows, w = gray.cols;
     int cell_h = h / board_size, cell_w = w / board_size;
 
@@ -92,15 +89,26 @@ int main() {
 
     cout << "按 q 退出程序" << endl;
 
+    BoardWarp board_warp(480);
+    BoardFilter filter(12);             // 多帧投票，滤掉手、阴影和反光造成的闪烁
+    Mat gray, warped, shown;
+
     while (true) {
         Mat frame;
         cap >> frame;
         if (frame.empty()) break;
 
-        vector<Point2f> corners = detect_board_corners_by_contour(frame);
+        cvtColor(frame, gray, COLOR_BGR2GRAY);
+        vector<Point2f> corners = detect_board_corners_by_contour(gray);
         if (corners.size() == 4) {
-            Mat warped = warp_board(frame, corners);
-            auto board = extract_board_state_gray_based(warped);
+            warp_board(gray, corners, board_warp, warped);
+            // 只有稳定下来的变化才作为落子事件输出
+            for (const BoardEvent& e : filter.update(extract_board_state_gray_based(warped))) {
+                if (e.isNewStone())
+                    cout << "新落子: " << (e.after == 1 ? "黑" : "白") << " (" << e.row << ", " << e.col << ")" << endl;
+            }
+            const auto& board = filter.stable();
+            cvtColor(warped, shown, COLOR_GRAY2BGR);
 
             int cell_size = warped.rows / 12;
             for (int i = 0; i < 12; ++i) {
@@ -109,10 +117,10 @@ int main() {
 
                     Point center(j * cell_size + cell_size / 2, i * cell_size + cell_size / 2);
                     Scalar color = (board[i][j] == 1) ? Scalar(0, 0, 255) : Scalar(0, 255, 0);
-                    circle(warped, center, 10, color, 2);
+                    circle(shown, center, 10, color, 2);
                 }
             }
-            imshow("Warped Board + Detected Pieces", warped);
+            imshow("Warped Board + Detected Pieces", shown);
 
             // 显示角点
             for (const auto& pt : corners) {
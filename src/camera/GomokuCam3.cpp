@@ -2,49 +2,17 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include "FramePipeline.h"
+#include "BoardTracker.h"
+#include "BoardWarp.h"
+#include "GridClassifier.h"
+#include "BoardFilter.h"
 
 using namespace cv;
 using namespace std;
 
-// Sort the corner points: top-left, top-right, bottom-right, bottom-left
-vector<Point2f> order_points(vector<Point> pts) {
-    vector<Point2f> rect(4);
-    vector<Point2f> floatPts(pts.begin(), pts.end());
-
-    sort(floatPts.begin(), floatPts.end(), [](Point2f a, Point2f b) {
-        return a.y < b.y || (a.y == b.y && a.x < b.x);
-    });
-
-    if (floatPts[0].x < floatPts[1].x) {
-        rect[0] = floatPts[0]; // top-left
-        rect[1] = floatPts[1]; // top-right
-    } else {
-        rect[0] = floatPts[1];
-        rect[1] = floatPts[0];
-    }
-
-    if (floatPts[2].x < floatPts[3].x) {
-        rect[3] = floatPts[2]; // bottom-left
-        rect[2] = floatPts[3]; // bottom-right
-    } else {
-        rect[3] = floatPts[3];
-        rect[2] = floatPts[2];
-    }
-
-    return rect;
-}
-
-// Determine the color of the piece based on average brightness
-string detect_piece_color(Mat& gray, int x, int y, int r) {
-    Mat mask = Mat::zeros(gray.size(), CV_8UC1);
-    circle(mask, Point(x, y), int(r * 0.7), Scalar(255), -1);
-    Scalar meanVal = mean(gray, mask);
-    double val = meanVal[0];
-    if (val < 70) return "black";
-    else if (val > 180) return "white";
-    else return "white";
-}
-
 // Check for five in a row
 int check_winner(const vector<vector<int>>& board) {
     vector<pair<int, int>> directions = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
@@ -70,113 +38,213 @@ int check_winner(const vector<vector<int>>& board) {
     return 0;
 }
 
-int main() {
-    const int grid_lines = 13;         // 13 lines = 12x12 grid intersections
-    const int board_size = 600;        // Size of the warped board image
-    const float spacing = board_size / float(grid_lines - 1);
+// Items passed between the pipeline stages, each with its capture time
+struct CapturedFrame {
+    Mat frame;
+    PipelineClock::time_point captured;
+};
+
+struct LocatedBoard {
+    Mat warped;                         // greyscale, board_size square
+    PipelineClock::time_point captured;
+};
+
+// Sent only when the filtered board changed: the stable board and the
+// cells that changed since the last state sent
+struct BoardState {
+    vector<vector<int>> board;
+    vector<BoardEvent> events;
+    PipelineClock::time_point captured;
+};
+
+const int grid_lines = 13;              // 13 lines = 12x12 grid intersections
+const int board_size = 600;             // Size of the warped board image
+const float spacing = board_size / float(grid_lines - 1);
+const int stone_sample_radius = 15;     // px on the warped board, inside a stone
+
+// Stage 1: grab frames at sensor rate, replacing any the localiser has
+// not taken yet
+void capture_stage(VideoCapture& cap, Mailbox<CapturedFrame>& out, Mailbox<Mat>& view,
+                   StageStats& stats, atomic<bool>& running) {
+    while (running) {
+        auto start = PipelineClock::now();
+        Mat frame;                      // fresh buffer: downstream stages still hold the last one
+        cap >> frame;
+        if (frame.empty()) {
+            running = false;
+            break;
+        }
+        auto end = PipelineClock::now();
+        stats.record(start, end);
 
-    VideoCapture cap(1);               // Open camera with device ID 1
-    if (!cap.isOpened()) {
-        cerr << "Cannot open camera" << endl;
-        return -1;
+        Mat shown = frame;
+        view.put(shown);
+        CapturedFrame captured{frame, end};
+        out.put(captured);
     }
+}
 
-    while (true) {
-        vector<vector<int>> board(13, vector<int>(13, 0));
-        Mat frame, gray, blur, edges;
-        cap >> frame;
-        if (frame.empty()) break;
-
-        frame.copyTo(gray);
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
-        GaussianBlur(gray, blur, Size(5, 5), 0);
-        Canny(blur, edges, 50, 150);   // Edge detection
-
-        vector<vector<Point>> contours;
-        findContours(edges, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-        sort(contours.begin(), contours.end(), [](const vector<Point>& a, const vector<Point>& b) {
-            return contourArea(a, false) > contourArea(b, false);
-        });
-
-        if (!contours.empty()) {
-            vector<Point> approx;
-            approxPolyDP(contours[0], approx, 0.02 * arcLength(contours[0], true), true);
-            if (approx.size() == 4) {
-                vector<Point2f> src_pts = order_points(approx);
-                vector<Point2f> dst_pts = {
-                    Point2f(0, 0),
-                    Point2f(board_size - 1, 0),
-                    Point2f(board_size - 1, board_size - 1),
-                    Point2f(0, board_size - 1)
-                };
-
-                Mat M = getPerspectiveTransform(src_pts, dst_pts);
-                Mat warped;
-                warpPerspective(frame, warped, M, Size(board_size, board_size));
-
-                Mat gray_warped;
-                cvtColor(warped, gray_warped, COLOR_BGR2GRAY);
-                GaussianBlur(gray_warped, gray_warped, Size(7, 7), 0);
-
-                vector<Point> grid_points;
-                for (int i = 0; i < grid_lines; i++) {
-                    for (int j = 0; j < grid_lines; j++) {
-                        int x = int(j * spacing);
-                        int y = int(i * spacing);
-                        grid_points.push_back(Point(x, y));
-                        circle(warped, Point(x, y), 2, Scalar(0, 255, 0), -1);
-                    }
-                }
-
-                vector<Vec3f> circles;
-                HoughCircles(gray_warped, circles, HOUGH_GRADIENT, 1.2, spacing * 0.8,
-                             100, 18, 18, 24);
-
-                for (size_t i = 0; i < circles.size(); i++) {
-                    int x = cvRound(circles[i][0]);
-                    int y = cvRound(circles[i][1]);
-                    int r = cvRound(circles[i][2]);
-
-                    double min_dist = DBL_MAX;
-                    Point nearest;
-                    for (const auto& gp : grid_points) {
-                        double dist = pow(gp.x - x, 2) + pow(gp.y - y, 2);
-                        if (dist < min_dist) {
-                            min_dist = dist;
-                            nearest = gp;
-                        }
-                    }
+// Stage 2: locate the board (tracked from the last frame with sub-pixel
+// corners, full contour detection only when tracking fails) and warp its
+// grey image through fixed-point tables, rebuilt only when the quad
+// moves. The warp writes into the buffers the mailbox hands back, so it
+// does not allocate per frame
+void localise_stage(Mailbox<CapturedFrame>& in, Mailbox<LocatedBoard>& out, BoardTracker& tracker,
+                    BoardWarp& board_warp, StageStats& stats, atomic<bool>& running) {
+    CapturedFrame item;
+    LocatedBoard located;
+    Mat gray;
+    while (waitLatest(in, item, running)) {
+        auto start = PipelineClock::now();
+        cvtColor(item.frame, gray, COLOR_BGR2GRAY);
+
+        if (tracker.locate(gray)) {
+            board_warp.update(tracker.corners());
+            board_warp.warp(gray, located.warped);
+            located.captured = item.captured;
+            out.put(located);               // located gets back a board the detector is done with
+        }
+        stats.record(start, PipelineClock::now());
+    }
+}
 
-                    if (min_dist < pow(spacing * 0.4, 2)) {
-                        string color = detect_piece_color(gray_warped, x, y, r);
-                        if (color != "unknown") {
-                            int row = round(nearest.y / spacing);
-                            int col = round(nearest.x / spacing);
-                            if (row >= 0 && row < 13 && col >= 0 && col < 13) {
-                                board[row][col] = (color == "black") ? 1 : 2;
-                                circle(warped, Point(x, y), r, Scalar(0, 0, 255), 2);
-                                circle(warped, Point(x, y), 2, Scalar(255, 0, 0), 3);
-                                putText(warped, color, Point(nearest.x + 5, nearest.y - 5),
-                                        FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 0, 0), 1);
-                            }
-                        }
-                    }
-                }
+// Stage 3: classify every intersection of the warped board from a disc
+// of pixels around it and filter the result over time. The decision
+// stage is only sent a state when a cell of the filtered board changed;
+// a state the queue has no room for is kept and merged with the next
+void detect_stage(Mailbox<LocatedBoard>& in, EventQueue<BoardState, 4>& out, Mailbox<Mat>& view,
+                  StageStats& stats, atomic<bool>& running) {
+    StoneThresholds thresholds;
+    thresholds.blackBelow = 70;
+    GridClassifier classifier(grid_lines, 0, spacing, stone_sample_radius, thresholds);
+    BoardFilter filter(grid_lines);
+    LocatedBoard item;
+    BoardState pending;
+    vector<vector<int>> board;
+    while (waitLatest(in, item, running)) {
+        auto start = PipelineClock::now();
+        classifier.classify(item.warped, board);
+        const vector<BoardEvent>& events = filter.update(board);
+        const vector<vector<int>>& stable = filter.stable();
+
+        if (!events.empty()) {
+            pending.events.insert(pending.events.end(), events.begin(), events.end());
+            pending.board = stable;
+            pending.captured = item.captured;
+        }
+        if (!pending.events.empty() && out.tryPush(std::move(pending))) pending = BoardState();
+
+        Mat warped;                     // colour copy for display only
+        cvtColor(item.warped, warped, COLOR_GRAY2BGR);
+        for (int i = 0; i < grid_lines; i++) {
+            for (int j = 0; j < grid_lines; j++) {
+                Point centre = classifier.cellCentre(i, j);
+                circle(warped, centre, 2, Scalar(0, 255, 0), -1);
+                if (stable[i][j] == 0) continue;
+
+                string color = (stable[i][j] == 1) ? "black" : "white";
+                circle(warped, centre, stone_sample_radius, Scalar(0, 0, 255), 2);
+                putText(warped, color, Point(centre.x + 5, centre.y - 5),
+                        FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 0, 0), 1);
+            }
+        }
 
-                int winner = check_winner(board);
-                if (winner != 0) {
-                    string text = (winner == 1) ? "Winner: BLACK" : "Winner: WHITE";
-                    putText(warped, text, Point(20, 40), FONT_HERSHEY_SIMPLEX,
-                            1, Scalar(0, 255, 255), 2);
-                }
+        view.put(warped);
+        stats.record(start, PipelineClock::now());
+    }
+}
 
-                imshow("Warped Board", warped);
+// Stage 4: wakes only on board changes and checks for a winner, which
+// the display thread reads from `winner`
+void decide_stage(EventQueue<BoardState, 4>& in, atomic<int>& winner, StageStats& stats,
+                  StageStats& end_to_end, atomic<bool>& running) {
+    BoardState item;
+    while (waitNext(in, item, running)) {
+        auto start = PipelineClock::now();
+        for (const BoardEvent& e : item.events) {
+            if (e.isNewStone()) {
+                cout << "New " << (e.after == 1 ? "black" : "white") << " stone at (" << e.row << ", "
+                     << e.col << ")" << endl;
             }
         }
+        winner = check_winner(item.board);
 
-        imshow("Original", frame);
-        if (waitKey(1) == 27) break;
+        auto end = PipelineClock::now();
+        stats.record(start, end);
+        end_to_end.record(item.captured, end);
     }
+}
+
+int main() {
+    VideoCapture cap(1);               // Open camera with device ID 1
+    if (!cap.isOpened()) {
+        cerr << "Cannot open camera" << endl;
+        return -1;
+    }
+
+    // capture -> localise -> detect -> decide, one thread each; the main
+    // thread only shows the newest images (HighGUI must stay on it)
+    Mailbox<CapturedFrame> latest_frame;
+    Mailbox<LocatedBoard> latest_board;
+    EventQueue<BoardState, 4> states_queue;
+    Mailbox<Mat> original_view, board_view;
+    StageStats capture_stats, localise_stats, detect_stats, decide_stats, end_to_end_stats;
+    BoardTracker tracker;
+    BoardWarp board_warp(board_size);
+    atomic<int> winner(0);
+    atomic<bool> running(true);
+
+    thread capture_thread(capture_stage, ref(cap), ref(latest_frame), ref(original_view),
+                          ref(capture_stats), ref(running));
+    thread localise_thread(localise_stage, ref(latest_frame), ref(latest_board), ref(tracker),
+                           ref(board_warp), ref(localise_stats), ref(running));
+    thread detect_thread(detect_stage, ref(latest_board), ref(states_queue),
+                         ref(board_view), ref(detect_stats), ref(running));
+    thread decide_thread(decide_stage, ref(states_queue), ref(winner), ref(decide_stats),
+                         ref(end_to_end_stats), ref(running));
+
+    StageReport capture_report("capture"), localise_report("localise"), detect_report("detect"),
+        decide_report("decide"), end_to_end_report("frame->event");
+    auto last_report = PipelineClock::now();
+    uint64_t last_rebuilds = 0;
+    Mat shown;
+
+    while (running) {
+        if (original_view.take(shown)) imshow("Original", shown);
+        if (board_view.take(shown)) {
+            if (winner != 0) {
+                string text = (winner == 1) ? "Winner: BLACK" : "Winner: WHITE";
+                putText(shown, text, Point(20, 40), FONT_HERSHEY_SIMPLEX,
+                        1, Scalar(0, 255, 255), 2);
+            }
+            imshow("Warped Board", shown);
+        }
+        if (waitKey(1) == 27) running = false;
+
+        // Once a second: rate and latency of each stage, warp table builds
+        // per second (near zero while the board is still), and frames
+        // dropped because the next stage was still busy
+        auto now = PipelineClock::now();
+        double seconds = chrono::duration<double>(now - last_report).count();
+        if (seconds >= 1.0) {
+            uint64_t rebuilds = board_warp.rebuilds();
+            cout << "[pipeline] " << capture_report.line(capture_stats, seconds)
+                 << " | " << localise_report.line(localise_stats, seconds)
+                 << " | " << detect_report.line(detect_stats, seconds)
+                 << " | " << decide_report.line(decide_stats, seconds)
+                 << " | " << end_to_end_report.line(end_to_end_stats, seconds)
+                 << " | warp tables " << cvRound((rebuilds - last_rebuilds) / seconds) << "/s"
+                 << " | dropped " << latest_frame.dropped() + latest_board.dropped()
+                 << endl;
+            last_report = now;
+            last_rebuilds = rebuilds;
+        }
+    }
+
+    capture_thread.join();
+    localise_thread.join();
+    detect_thread.join();
+    decide_thread.join();
 
     cap.release();
     destroyAllWindows();
@@ -3,6 +3,13 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include "FramePipeline.h"
+#include "BoardTracker.h"
+#include "BoardWarp.h"
+#include "GridClassifier.h"
+#include "BoardFilter.h"
 
 using namespace cv;
 using namespace std;
@@ -13,35 +20,8 @@ const int BOARD_PIXEL_SIZE = 600;
 const float GRID_PIXEL_SPACING = BOARD_PIXEL_SIZE / (float)(GRID_SIZE - 1);
 const float GRID_MM_SPACING = 15.0f;
 const Point2f WORLD_ORIGIN(100, 100); // mm
-
-// Order 4 corner points (top-left, top-right, bottom-right, bottom-left)
-vector<Point2f> orderPoints(vector<Point> pts) {
-    vector<Point2f> rect(4);
-    vector<Point2f> fp(4);
-    for (int i = 0; i < 4; ++i) fp[i] = Point2f(pts[i].x, pts[i].y);
-
-    float s[4], d[4];
-    for (int i = 0; i < 4; ++i) {
-        s[i] = fp[i].x + fp[i].y;
-        d[i] = fp[i].x - fp[i].y;
-    }
-
-    rect[0] = fp[min_element(s, s + 4) - s]; // top-left
-    rect[2] = fp[max_element(s, s + 4) - s]; // bottom-right
-    rect[1] = fp[min_element(d, d + 4) - d]; // top-right
-    rect[3] = fp[max_element(d, d + 4) - d]; // bottom-left
-    return rect;
-}
-
-// Simple brightness-based piece color detection
-string detectPieceColor(Mat& gray, int x, int y, int r) {
-    Mat mask = Mat::zeros(gray.size(), CV_8UC1);
-    circle(mask, Point(x, y), int(r * 0.7), Scalar(255), -1);
-    Scalar meanVal = mean(gray, mask);
-    if (meanVal[0] < 80) return "black";
-    if (meanVal[0] > 130) return "white";
-    return "white";
-}
+const int STONE_SAMPLE_RADIUS = 15;    // px on the warped board, inside a stone
+const int PATCH_SIZE = 2 * STONE_SAMPLE_RADIUS + 1;
 
 // Convert grid index to real-world coordinates (mm)
 Point2f gridToWorld(int row, int col) {
@@ -93,6 +73,145 @@ Point getAIMove(vector<vector<int>>& board) {
     return bestMove;
 }
 
+// Items passed between the pipeline stages. Each carries the capture
+// time so the decision stage can measure frame-to-move latency
+struct CapturedFrame {
+    Mat frame;
+    PipelineClock::time_point captured;
+};
+
+struct LocatedBoard {
+    Mat warped;                         // greyscale intersection patches, see BoardWarp::warpPatches
+    PipelineClock::time_point captured;
+};
+
+// Sent only when the filtered board changed: the stable board and the
+// cells that changed since the last state sent
+struct BoardState {
+    vector<vector<int>> board;
+    vector<BoardEvent> events;
+    PipelineClock::time_point captured;
+};
+
+// Stage 1: grab frames at sensor rate. Never waits on the other stages;
+// a frame the localiser has not taken yet is replaced by the next
+void captureStage(VideoCapture& cap, Mailbox<CapturedFrame>& out, Mailbox<Mat>& view,
+                  StageStats& stats, atomic<bool>& running) {
+    while (running) {
+        auto start = PipelineClock::now();
+        Mat frame;                      // fresh buffer: downstream stages still hold the last one
+        cap >> frame;
+        if (frame.empty()) {
+            running = false;
+            break;
+        }
+        auto end = PipelineClock::now();
+        stats.record(start, end);
+
+        Mat shown = frame;
+        view.put(shown);
+        CapturedFrame captured{frame, end};
+        out.put(captured);
+    }
+}
+
+// Stage 2: locate the board (tracked from the last frame, full contour
+// detection only when tracking fails) and warp the patches around the
+// intersections out of the grey frame through cached fixed-point tables.
+// The warp writes into the buffers the mailbox hands back, so it does not
+// allocate per frame
+void localiseStage(Mailbox<CapturedFrame>& in, Mailbox<LocatedBoard>& out, BoardTracker& tracker, BoardWarp& boardWarp,
+                   StageStats& stats, atomic<bool>& running) {
+    CapturedFrame item;
+    LocatedBoard located;
+    Mat gray;
+    while (waitLatest(in, item, running)) {
+        auto start = PipelineClock::now();
+        cvtColor(item.frame, gray, COLOR_BGR2GRAY);
+
+        if (tracker.locate(gray)) {
+            boardWarp.update(tracker.corners());
+            boardWarp.warpPatches(gray, located.warped);
+            located.captured = item.captured;
+            out.put(located);               // located gets back a board the detector is done with
+        }
+        stats.record(start, PipelineClock::now());
+    }
+}
+
+// Stage 3: classify every intersection from its patch and filter the
+// result over time. The decision stage is only sent a state when a cell
+// of the filtered board changed; a state the queue has no room for is
+// kept and its events merged with the next ones, never dropped
+void detectStage(Mailbox<LocatedBoard>& in, EventQueue<BoardState, 4>& out, Mailbox<Mat>& view,
+                 StageStats& stats, atomic<bool>& running) {
+    GridClassifier classifier(GRID_SIZE, PATCH_SIZE / 2, PATCH_SIZE, STONE_SAMPLE_RADIUS);
+    BoardFilter filter(GRID_SIZE);
+    LocatedBoard item;
+    BoardState pending;
+    vector<vector<int>> board;
+    while (waitLatest(in, item, running)) {
+        auto start = PipelineClock::now();
+        classifier.classify(item.warped, board);
+        const vector<BoardEvent>& events = filter.update(board);
+        const vector<vector<int>>& stable = filter.stable();
+
+        if (!events.empty()) {
+            pending.events.insert(pending.events.end(), events.begin(), events.end());
+            pending.board = stable;
+            pending.captured = item.captured;
+        }
+        if (!pending.events.empty() && out.tryPush(std::move(pending))) pending = BoardState();
+
+        Mat shown;                      // colour copy for display only
+        cvtColor(item.warped, shown, COLOR_GRAY2BGR);
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int col = 0; col < GRID_SIZE; ++col) {
+                if (stable[row][col] == 0) continue;
+                Scalar color = stable[row][col] == 1 ? Scalar(0, 0, 255) : Scalar(0, 255, 0);
+                circle(shown, classifier.cellCentre(row, col), STONE_SAMPLE_RADIUS, color, 2);
+            }
+        }
+
+        view.put(shown);
+        stats.record(start, PipelineClock::now());
+    }
+}
+
+// Stage 4: wakes only on board changes. Once a new black stone is stable
+// it is white's turn: pick and report the AI move. However long this
+// takes, the stages before it keep running on fresh frames
+void decideStage(EventQueue<BoardState, 4>& in, StageStats& stats, StageStats& endToEnd,
+                 atomic<bool>& running) {
+    string turn = "black";
+    BoardState item;
+    while (waitNext(in, item, running)) {
+        auto start = PipelineClock::now();
+        for (const BoardEvent& e : item.events) {
+            if (!e.isNewStone()) continue;
+            cout << "[Board] New " << (e.after == 1 ? "black" : "white") << " stone at row=" << e.row
+                 << " col=" << e.col << endl;
+            if (e.after == 1) turn = "white";
+        }
+
+        if (turn == "white") {
+            Point aiMove = getAIMove(item.board);
+            if (aiMove.x != -1) {
+                Point2f worldPos = gridToWorld(aiMove.y, aiMove.x);
+                cout << "[AI] White move at row=" << aiMove.y
+                     << " col=" << aiMove.x
+                     << " → World(mm): " << worldPos << endl;
+
+                // TODO: robotic arm control function here
+                turn = "black";
+            }
+        }
+        auto end = PipelineClock::now();
+        stats.record(start, end);
+        endToEnd.record(item.captured, end);
+    }
+}
+
 int main() {
     VideoCapture cap(0);
     if (!cap.isOpened()) {
@@ -100,83 +219,63 @@ int main() {
         return -1;
     }
 
-    string turn = "black";
+    // capture -> localise -> detect -> decide, one thread each; the main
+    // thread only shows the newest images (HighGUI must stay on it)
+    Mailbox<CapturedFrame> latestFrame;
+    Mailbox<LocatedBoard> latestBoard;
+    EventQueue<BoardState, 4> statesQueue;
+    Mailbox<Mat> originalView, boardView;
+    StageStats captureStats, localiseStats, detectStats, decideStats, endToEndStats;
+    BoardTracker tracker;
+    BoardWarp boardWarp(BOARD_PIXEL_SIZE);
+    boardWarp.enablePatches(GRID_SIZE, GRID_PIXEL_SPACING, PATCH_SIZE);
+    atomic<bool> running(true);
 
-    while (true) {
-        Mat frame;
-        cap >> frame;
-        if (frame.empty()) break;
-
-        Mat gray, blurred, edges;
-        cvtColor(frame, gray, COLOR_BGR2GRAY);
-        GaussianBlur(gray, blurred, Size(7, 7), 0);
-        Canny(blurred, edges, 50, 150);
-
-        vector<vector<Point>> contours;
-        findContours(edges, contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-        sort(contours.begin(), contours.end(), [](const vector<Point>& a, const vector<Point>& b) {
-            return contourArea(a) > contourArea(b);
-        });
-
-        if (!contours.empty()) {
-            vector<Point> approx;
-            approxPolyDP(contours[0], approx, arcLength(contours[0], true) * 0.02, true);
-
-            if (approx.size() == 4) {
-                vector<Point2f> src_pts = orderPoints(approx);
-                vector<Point2f> dst_pts = {
-                    Point2f(0, 0), Point2f(BOARD_PIXEL_SIZE - 1, 0),
-                    Point2f(BOARD_PIXEL_SIZE - 1, BOARD_PIXEL_SIZE - 1),
-                    Point2f(0, BOARD_PIXEL_SIZE - 1)
-                };
-
-                Mat M = getPerspectiveTransform(src_pts, dst_pts);
-                Mat warped;
-                warpPerspective(frame, warped, M, Size(BOARD_PIXEL_SIZE, BOARD_PIXEL_SIZE));
-
-                vector<vector<int>> board(13, vector<int>(13, 0));
-                Mat grayWarped;
-                cvtColor(warped, grayWarped, COLOR_BGR2GRAY);
-                GaussianBlur(grayWarped, blurred, Size(5, 5), 0);
-
-                vector<Vec3f> circles;
-                HoughCircles(blurred, circles, HOUGH_GRADIENT, 1.2, GRID_PIXEL_SPACING * 0.8,
-                             100, 18, 18, 24);
-
-                for (auto c : circles) {
-                    int x = cvRound(c[0]), y = cvRound(c[1]), r = cvRound(c[2]);
-
-                    int row = round(y / GRID_PIXEL_SPACING);
-                    int col = round(x / GRID_PIXEL_SPACING);
-
-                    if (row >= 0 && row < 13 && col >= 0 && col < 13) {
-                        string color = detectPieceColor(grayWarped, x, y, r);
-                        board[row][col] = (color == "black") ? 1 : 2;
-                        circle(warped, Point(x, y), r, Scalar(0, 0, 255), 2);
-                    }
-                }
+    thread captureThread(captureStage, ref(cap), ref(latestFrame), ref(originalView),
+                         ref(captureStats), ref(running));
+    thread localiseThread(localiseStage, ref(latestFrame), ref(latestBoard), ref(tracker),
+                          ref(boardWarp), ref(localiseStats), ref(running));
+    thread detectThread(detectStage, ref(latestBoard), ref(statesQueue), ref(boardView),
+                        ref(detectStats), ref(running));
+    thread decideThread(decideStage, ref(statesQueue), ref(decideStats), ref(endToEndStats), ref(running));
 
-                if (turn == "white") {
-                    Point aiMove = getAIMove(board);
-                    if (aiMove.x != -1) {
-                        Point2f worldPos = gridToWorld(aiMove.y, aiMove.x);
-                        cout << "[AI] White move at row=" << aiMove.y
-                             << " col=" << aiMove.x
-                             << " → World(mm): " << worldPos << endl;
+    StageReport captureReport("capture"), localiseReport("localise"), detectReport("detect"),
+        decideReport("decide"), endToEndReport("frame->move");
+    auto lastReport = PipelineClock::now();
+    uint64_t lastRebuilds = 0;
+    Mat shown;
 
-                        // TODO: robotic arm control function here
-                        turn = "black";
-                    }
-                }
+    while (running) {
+        if (originalView.take(shown)) imshow("Original", shown);
+        if (boardView.take(shown)) imshow("Board Patches", shown);
+        if (waitKey(1) == 27) running = false;
 
-                imshow("Warped Board", warped);
-            }
+        // Once a second: rate and latency of each stage, warp table builds
+        // per second (near zero while the board is still), and frames
+        // dropped because the next stage was still busy
+        auto now = PipelineClock::now();
+        double seconds = chrono::duration<double>(now - lastReport).count();
+        if (seconds >= 1.0) {
+            uint64_t rebuilds = boardWarp.rebuilds();
+            cout << "[pipeline] " << captureReport.line(captureStats, seconds)
+                 << " | " << localiseReport.line(localiseStats, seconds)
+                 << " | " << detectReport.line(detectStats, seconds)
+                 << " | " << decideReport.line(decideStats, seconds)
+                 << " | " << endToEndReport.line(endToEndStats, seconds)
+                 << " | tracked " << tracker.trackedFrames() << "/" << tracker.fullDetections() << " detected"
+                 << " | warp tables " << cvRound((rebuilds - lastRebuilds) / seconds) << "/s"
+                 << " | dropped " << latestFrame.dropped() + latestBoard.dropped()
+                 << endl;
+            lastReport = now;
+            lastRebuilds = rebuilds;
         }
-
-        imshow("Original", frame);
-        if (waitKey(1) == 27) break;
     }
 
+    captureThread.join();
+    localiseThread.join();
+    detectThread.join();
+    decideThread.join();
+
     cap.release();
     destroyAllWindows();
     return 0;
@@ -0,0 +1,121 @@
+#ifndef GRID_CLASSIFIER_H
+#define GRID_CLASSIFIER_H
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Reads the board state straight off the grid intersections: for each of
+// the gridLines x gridLines cells it takes the mean and standard
+// deviation of a disc around the intersection and decides empty, black
+// or white. The discs are precomputed once per image geometry as lists
+// of row spans (byte offset, length), clipped to the image, so a
+// classification is a single pass over those pixels: no HoughCircles, no
+// mask images, no allocation.
+//
+// A stone is uniform, while an empty intersection shows the grid lines
+// crossing it, so a disc is a stone only if its deviation is low; the
+// mean then tells black from white.
+struct StoneThresholds {
+    double blackBelow = 80;             // mean brightness of a black stone
+    double whiteAbove = 130;            // mean brightness of a white stone
+    double stoneDeviation = 28;         // a stone's disc deviates less than this
+};
+
+class GridClassifier {
+public:
+    // Cell (row, col) is centred at pixel (origin + col * spacing,
+    // origin + row * spacing) of the image passed to classify
+    GridClassifier(int gridLines, float origin, float spacing, int radius,
+                   const StoneThresholds& thresholds = StoneThresholds())
+        : lines_(gridLines), origin_(origin), spacing_(spacing), radius_(radius), thresholds_(thresholds),
+          means_(gridLines * gridLines), deviations_(gridLines * gridLines) {}
+
+    // Classify every cell of a greyscale (CV_8UC1) image into board:
+    // 0 empty, 1 black, 2 white
+    void classify(const cv::Mat& gray, std::vector<std::vector<int>>& board) {
+        if (gray.rows != builtRows_ || gray.cols != builtCols_ || gray.step != builtStep_) buildSpans(gray);
+        if (int(board.size()) != lines_) board.assign(lines_, std::vector<int>(lines_, 0));
+        for (auto& row : board) std::fill(row.begin(), row.end(), 0);
+
+        const uchar* base = gray.data;
+        for (int cell = 0; cell < lines_ * lines_; ++cell) {
+            unsigned sum = 0, count = 0;
+            uint64_t sumSq = 0;
+            for (int s = cellBegin_[cell]; s < cellBegin_[cell + 1]; ++s) {
+                const uchar* p = base + spans_[s].offset;
+                for (int k = 0; k < spans_[s].length; ++k) {
+                    sum += p[k];
+                    sumSq += unsigned(p[k]) * p[k];
+                }
+                count += spans_[s].length;
+            }
+            if (count == 0) continue;
+
+            double mean = double(sum) / count;
+            double deviation = std::sqrt(std::max(0.0, double(sumSq) / count - mean * mean));
+            means_[cell] = float(mean);
+            deviations_[cell] = float(deviation);
+
+            if (deviation >= thresholds_.stoneDeviation) continue;
+            if (mean < thresholds_.blackBelow) board[cell / lines_][cell % lines_] = 1;
+            else if (mean > thresholds_.whiteAbove) board[cell / lines_][cell % lines_] = 2;
+        }
+    }
+
+    // Disc statistics of the last classify, for tuning the thresholds
+    float cellMean(int row, int col) const { return means_[row * lines_ + col]; }
+    float cellDeviation(int row, int col) const { return deviations_[row * lines_ + col]; }
+
+    // Pixel centre of a cell
+    cv::Point cellCentre(int row, int col) const {
+        return cv::Point(cvRound(origin_ + col * spacing_), cvRound(origin_ + row * spacing_));
+    }
+
+private:
+    struct Span {
+        size_t offset;
+        int length;
+    };
+
+    int lines_;
+    float origin_;
+    float spacing_;
+    int radius_;
+    StoneThresholds thresholds_;
+    int builtRows_ = -1;
+    int builtCols_ = -1;
+    size_t builtStep_ = 0;
+    std::vector<Span> spans_;
+    std::vector<int> cellBegin_;        // spans of cell c: [cellBegin_[c], cellBegin_[c + 1])
+    std::vector<float> means_;
+    std::vector<float> deviations_;
+
+    void buildSpans(const cv::Mat& gray) {
+        builtRows_ = gray.rows;
+        builtCols_ = gray.cols;
+        builtStep_ = gray.step;
+        spans_.clear();
+        cellBegin_.assign(1, 0);
+
+        for (int row = 0; row < lines_; ++row) {
+            for (int col = 0; col < lines_; ++col) {
+                cv::Point c = cellCentre(row, col);
+                for (int dy = -radius_; dy <= radius_; ++dy) {
+                    int y = c.y + dy;
+                    if (y < 0 || y >= gray.rows) continue;
+                    int half = int(std::sqrt(double(radius_ * radius_ - dy * dy)));
+                    int x0 = std::max(0, c.x - half);
+                    int x1 = std::min(gray.cols - 1, c.x + half);
+                    if (x0 > x1) continue;
+                    spans_.push_back({y * gray.step + x0, x1 - x0 + 1});
+                }
+                cellBegin_.push_back(int(spans_.size()));
+            }
+        }
+    }
+};
+
+#endif // GRID_CLASSIFIER_H
@@ -0,0 +1,125 @@
+#include "minimax_engine.h"
+#include "bitboard.h"
+#include "evaluator.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ * Regression test: the engines specialised on the board size must search
+ * exactly like the runtime-sized engine, i.e. pick the same move after
+ * visiting the same number of nodes, and the move ordering estimate of
+ * both must equal threat_score() on every cell.
+ */
+template <int Size>
+static int compare_sizes(std::mt19937& rng)
+{
+    int failures = 0;
+    std::vector<std::pair<int, int>> cells;
+    for (int x = 0; x < Size; x++)
+        for (int y = 0; y < Size; y++)
+            cells.push_back({x, y});
+
+    for (int game = 0; game < 10; game++) {
+        // A random opening near the centre plus a few stones anywhere,
+        // so the line tables get exercised at the edges too
+        std::vector<std::pair<int, int>> player, opponent;
+        std::shuffle(cells.begin(), cells.end(), rng);
+        int placed = 0;
+        for (const auto& pt : cells) {
+            bool central = std::abs(pt.first - Size / 2) <= 3 && std::abs(pt.second - Size / 2) <= 3;
+            if (!central && placed >= 8)
+                continue;
+            (placed % 2 ? opponent : player).push_back(pt);
+            if (++placed == 12)
+                break;
+        }
+
+        MinimaxEngine<Size, Size> fixed({Size, Size}, 2, 1.0, 1 << 12, 1);
+        MinimaxEngine<0, 0> runtime({Size, Size}, 2, 1.0, 1 << 12, 1);
+        auto a = fixed.get_next_move(player, opponent);
+        auto b = runtime.get_next_move(player, opponent);
+        int nodes_a = fixed.get_statistics()["search_count"];
+        int nodes_b = runtime.get_statistics()["search_count"];
+        if (a != b || nodes_a != nodes_b) {
+            std::cout << "Mismatch on " << Size << "x" << Size << " game " << game << ": ("
+                      << a.first << ", " << a.second << ") " << nodes_a << " nodes vs ("
+                      << b.first << ", " << b.second << ") " << nodes_b << " nodes" << std::endl;
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// threat_estimate() of an engine holding the stones against threat_score()
+// on a Bitboard holding them, for both sides on every cell
+template <int Cols, int Rows>
+static int compare_estimates(int size, const std::vector<std::pair<int, int>>& player,
+                             const std::vector<std::pair<int, int>>& opponent)
+{
+    MinimaxEngine<Cols, Rows> engine({size, size}, 1, 1.0, 0, 1);
+    Bitboard board(size, size);
+    for (const auto& pt : player) {
+        engine.apply_move(0, pt);
+        board.make(0, pt.first, pt.second);
+    }
+    for (const auto& pt : opponent) {
+        engine.apply_move(1, pt);
+        board.make(1, pt.first, pt.second);
+    }
+
+    int failures = 0;
+    for (int side = 0; side < 2; side++) {
+        for (int x = 0; x < size; x++) {
+            for (int y = 0; y < size; y++) {
+                int expected = threat_score(board, side, x, y);
+                int estimate = engine.threat_estimate(side, x * size + y);
+                if (estimate != expected) {
+                    std::cout << size << "x" << size << " side " << side << " (" << x << ", " << y << "): estimate "
+                              << estimate << ", threat_score " << expected << std::endl;
+                    failures++;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+template <int Size>
+static int check_estimates(std::mt19937& rng)
+{
+    // Broken and blocked threes and fours on the anti-diagonal, where an
+    // estimate read in the other direction would differ
+    std::vector<std::pair<int, int>> player = {{3, 8}, {4, 7}, {6, 5}, {8, 8}, {9, 7}, {10, 6}};
+    std::vector<std::pair<int, int>> opponent = {{2, 9}, {7, 4}, {11, 5}, {5, 5}};
+    int failures = compare_estimates<Size, Size>(Size, player, opponent) +
+                   compare_estimates<0, 0>(Size, player, opponent);
+
+    // Random mixed positions
+    std::vector<std::pair<int, int>> cells;
+    for (int x = 0; x < Size; x++)
+        for (int y = 0; y < Size; y++)
+            cells.push_back({x, y});
+    for (int game = 0; game < 5; game++) {
+        std::shuffle(cells.begin(), cells.end(), rng);
+        player.assign(cells.begin(), cells.begin() + Size * 2);
+        opponent.assign(cells.begin() + Size * 2, cells.begin() + Size * 4);
+        failures += compare_estimates<Size, Size>(Size, player, opponent) +
+                    compare_estimates<0, 0>(Size, player, opponent);
+    }
+    return failures;
+}
+
+int main()
+{
+    std::mt19937 rng(2024);
+    int failures = compare_sizes<12>(rng) + compare_sizes<13>(rng) + compare_sizes<15>(rng);
+    failures += check_estimates<12>(rng) + check_estimates<13>(rng) + check_estimates<15>(rng);
+
+    std::cout << "30 positions searched, 18 estimated, " << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
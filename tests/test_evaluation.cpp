@@ -0,0 +1,119 @@
+#include "bitboard.h"
+#include "evaluator.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ * Every entry of the window lookup table must equal matching the
+ * shape_score patterns one by one, the way cal_score used to.
+ */
+static int check_window_table()
+{
+    int failures = 0;
+    for (int code = 0; code < WINDOW_CODES; code++) {
+        std::vector<int> pos;
+        for (int i = 0, rest = code; i < 6; i++, rest /= 3)
+            pos.insert(pos.begin(), rest % 3);
+        std::vector<int> tmp_shape5(pos.begin(), pos.begin() + 5);
+
+        int expected = 0;
+        for (const auto& shape_pair : shape_score_table()) {
+            const auto& shape = shape_pair.second;
+            bool matched = shape.size() == 5 ? std::equal(shape.begin(), shape.end(), tmp_shape5.begin())
+                                             : std::equal(shape.begin(), shape.end(), pos.begin());
+            if (matched && shape_pair.first > expected)
+                expected = shape_pair.first;
+        }
+
+        if (window_code(pos.data()) != code || window_score(pos.data()) != expected) {
+            std::cout << "Window table mismatch for code " << code << std::endl;
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * The incremental LineEvaluator must give exactly the scores of the
+ * stone-by-stone cal_score scan, after every make and every unmake.
+ */
+int main()
+{
+    std::mt19937 rng(2024);
+    int failures = check_window_table();
+    int checks = 0;
+
+    for (int size : {12, 13, 15}) {
+        Bitboard board(size, size);
+        LineEvaluator evaluator;
+        std::vector<std::pair<int, int>> cells;
+        for (int x = 0; x < size; x++)
+            for (int y = 0; y < size; y++)
+                cells.push_back({x, y});
+
+        for (int game = 0; game < 60; game++) {
+            board.clear();
+            evaluator.reset(board);
+            std::shuffle(cells.begin(), cells.end(), rng);
+
+            // Cluster the stones so that real shapes appear
+            int centre = size / 2;
+            std::stable_sort(cells.begin(), cells.end(), [&](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                int da = std::max(std::abs(a.first - centre), std::abs(a.second - centre));
+                int db = std::max(std::abs(b.first - centre), std::abs(b.second - centre));
+                return da / 2 < db / 2;
+            });
+
+            int stones = 20 + game % 40;
+            std::vector<std::pair<int, int>> played;
+            for (int k = 0; k < stones; k++) {
+                const auto& pt = cells[k];
+                board.make(k % 2, pt.first, pt.second);
+                evaluator.update(board, pt.first, pt.second);
+                played.push_back(pt);
+
+                // Take some stones back to exercise unmake
+                if (rng() % 5 == 0) {
+                    const auto& back = played.back();
+                    board.unmake(k % 2, back.first, back.second);
+                    evaluator.update(board, back.first, back.second);
+                    played.pop_back();
+                    board.make(k % 2, back.first, back.second);
+                    evaluator.update(board, back.first, back.second);
+                    played.push_back(back);
+                }
+
+                for (int side = 0; side < 2; side++) {
+                    int expected = scan_side_score(board, side);
+                    int actual = evaluator.score(side);
+                    checks++;
+                    if (expected != actual) {
+                        if (failures < 10)
+                            std::cout << "Mismatch on " << size << "x" << size << " game " << game
+                                      << " stone " << k << " side " << side << ": expected "
+                                      << expected << ", got " << actual << std::endl;
+                        failures++;
+                    }
+                }
+            }
+
+            // Unwind completely; an empty board scores zero
+            for (int k = static_cast<int>(played.size()) - 1; k >= 0; k--) {
+                board.unmake(k % 2, played[k].first, played[k].second);
+                evaluator.update(board, played[k].first, played[k].second);
+            }
+            if (evaluator.score(0) != 0 || evaluator.score(1) != 0) {
+                std::cout << "Non-zero score after unwinding" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    std::cout << checks << " positions compared, " << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include "bitboard.h"
+#include "line_kernel.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/**
+ * Differential test: every five-in-a-row kernel this CPU supports must
+ * agree with the cell-by-cell scan, for both sides, on random positions
+ * of every board size the kernels handle (and on a larger board, which
+ * falls back to the scan).
+ */
+int main()
+{
+    std::mt19937 rng(4242);
+    int failures = 0;
+    int checks = 0;
+
+    std::vector<LineKernel> kernels;
+    for (LineKernel kernel : {LINE_KERNEL_SCALAR, LINE_KERNEL_SSE2, LINE_KERNEL_AVX2, LINE_KERNEL_NEON}) {
+        if (line_kernel_supported(kernel)) {
+            kernels.push_back(kernel);
+            std::cout << "Testing kernel " << line_kernel_name(kernel) << std::endl;
+        }
+    }
+
+    std::vector<std::pair<int, int>> sizes = {{5, 5}, {8, 11}, {12, 12}, {13, 13}, {15, 15}, {16, 16}, {16, 9}, {19, 19}};
+    for (const auto& size : sizes) {
+        int columns = size.first;
+        int rows = size.second;
+        Bitboard board(columns, rows);
+        std::vector<std::pair<int, int>> cells;
+        for (int x = 0; x < columns; x++)
+            for (int y = 0; y < rows; y++)
+                cells.push_back({x, y});
+
+        for (int game = 0; game < 200; game++) {
+            board.clear();
+            std::shuffle(cells.begin(), cells.end(), rng);
+            int stones = static_cast<int>(rng() % cells.size());
+
+            // Sparse and dense positions, one side sometimes much denser
+            for (int k = 0; k < stones; k++) {
+                int side = (game % 3 == 0) ? (rng() % 4 == 0) : k % 2;
+                board.make(side, cells[k].first, cells[k].second);
+            }
+
+            int expected = (board.check_win_scan(0) ? 1 : 0) | (board.check_win_scan(1) ? 2 : 0);
+            checks++;
+            if (board.fives() != expected || board.check_win(0) != (expected & 1) ||
+                board.check_win(1) != ((expected & 2) != 0)) {
+                std::cout << "Bitboard mismatch on " << columns << "x" << rows << " game " << game << std::endl;
+                failures++;
+            }
+
+            if (columns > KERNEL_MAX_SIZE || rows > KERNEL_MAX_SIZE)
+                continue;
+            uint16_t masks[2 * KERNEL_MAX_SIZE] = {};
+            for (int side = 0; side < 2; side++)
+                for (const auto& pt : board.pieces(side))
+                    masks[side * KERNEL_MAX_SIZE + pt.first] |= static_cast<uint16_t>(1u << pt.second);
+            for (LineKernel kernel : kernels) {
+                int found = find_fives(masks, kernel);
+                if (found != expected) {
+                    std::cout << line_kernel_name(kernel) << " kernel on " << columns << "x" << rows
+                              << " game " << game << ": expected " << expected << ", got " << found << std::endl;
+                    failures++;
+                }
+            }
+        }
+    }
+
+    std::cout << checks << " positions compared, " << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
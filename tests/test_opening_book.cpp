@@ -0,0 +1,106 @@
+#include "minimax_algorithm.h"
+#include "board_symmetry.h"
+#include "opening_book.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <utility>
+#include <cstdio>
+
+/**
+ * Opening book: symmetries invert correctly, a book written to disk maps
+ * back in, and the engine plays the stored move for every rotation and
+ * reflection of a book position, mapped into that orientation.
+ */
+int main()
+{
+    int failures = 0;
+
+    // Every symmetry is undone by its inverse
+    for (auto size : std::vector<std::pair<int, int>>{{15, 15}, {12, 9}}) {
+        for (int s = 0; s < symmetry_count(size.first, size.second); s++) {
+            for (int x = 0; x < size.first; x++) {
+                for (int y = 0; y < size.second; y++) {
+                    auto there = apply_symmetry(s, x, y, size.first, size.second);
+                    auto back = apply_symmetry(inverse_symmetry(s), there.first, there.second, size.first, size.second);
+                    if (back != std::make_pair(x, y)) {
+                        std::cout << "Symmetry " << s << " not inverted at (" << x << ", " << y << ")" << std::endl;
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    // A one-position book for an asymmetric position
+    const int size = 15;
+    std::vector<std::pair<int, int>> player = {{7, 7}, {8, 9}};
+    std::vector<std::pair<int, int>> opponent = {{7, 8}, {10, 10}};
+    std::pair<int, int> book_move = {9, 6};
+
+    Bitboard board(size, size);
+    for (const auto& pt : player)
+        board.make(0, pt.first, pt.second);
+    for (const auto& pt : opponent)
+        board.make(1, pt.first, pt.second);
+    ZobristKeys keys;
+    keys.reset(size * size);
+    int symmetry;
+    uint64_t key = canonical_key(board, keys, symmetry);
+    auto stored = apply_symmetry(symmetry, book_move.first, book_move.second, size, size);
+
+    const char* path = "test_opening_book.bin";
+    if (!write_opening_book(path, size, size, {{key, static_cast<uint16_t>(board.index(stored.first, stored.second)), 9}})) {
+        std::cout << "Cannot write the book" << std::endl;
+        return 1;
+    }
+
+    MinimaxAlgorithm minimax({size, size}, 3, 1.0);
+    MinimaxAlgorithm other_size({13, 13}, 3, 1.0);
+    if (!minimax.load_opening_book(path) || other_size.load_opening_book(path) ||
+        minimax.load_opening_book("no_such_book.bin")) {
+        std::cout << "Book loading accepted or refused the wrong file" << std::endl;
+        failures++;
+    }
+    minimax.load_opening_book(path);
+
+    for (int s = 0; s < 8; s++) {
+        std::vector<std::pair<int, int>> p, o;
+        for (const auto& pt : player)
+            p.push_back(apply_symmetry(s, pt.first, pt.second, size, size));
+        for (const auto& pt : opponent)
+            o.push_back(apply_symmetry(s, pt.first, pt.second, size, size));
+        auto expected = apply_symmetry(s, book_move.first, book_move.second, size, size);
+
+        auto move = minimax.get_next_move(p, o);
+        if (move != expected || minimax.get_statistics()["book_hit"] != 1) {
+            std::cout << "Symmetry " << s << ": got (" << move.first << ", " << move.second << "), expected ("
+                      << expected.first << ", " << expected.second << ")" << std::endl;
+            failures++;
+        }
+    }
+
+    // A position not in the book is searched
+    minimax.get_next_move({{7, 7}}, {{7, 8}});
+    if (minimax.get_statistics()["book_hit"] != 0) {
+        std::cout << "Book hit for a position not in the book" << std::endl;
+        failures++;
+    }
+
+    // A truncated file is refused
+    {
+        std::ofstream bad("test_opening_book_bad.bin", std::ios::binary);
+        bad << "GOBOOK01 but too short to be a book";
+    }
+    OpeningBook bad_book;
+    if (bad_book.open("test_opening_book_bad.bin")) {
+        std::cout << "Malformed book accepted" << std::endl;
+        failures++;
+    }
+    std::remove(path);
+    std::remove("test_opening_book_bad.bin");
+
+    std::cout << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
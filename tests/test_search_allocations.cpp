@@ -0,0 +1,84 @@
+#include "minimax_algorithm.h"
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <new>
+#include <cstdlib>
+#include <atomic>
+
+// Every heap allocation in the program goes through these
+static std::atomic<long> allocation_count(0);
+
+void* operator new(std::size_t size)
+{
+    allocation_count++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+struct Position {
+    std::vector<std::pair<int, int>> player_pieces;
+    std::vector<std::pair<int, int>> opponent_pieces;
+};
+
+/**
+ * The search must not touch the heap once its buffers have been sized:
+ * after a warm-up call, get_next_move on other positions of the same
+ * board performs zero allocations, however many nodes it visits.
+ */
+static int check_board(std::pair<int, int> size, int depth, const std::vector<Position>& positions)
+{
+    int failures = 0;
+    MinimaxAlgorithm minimax(size, depth, 1.0, 1 << 12, 1);
+    minimax.get_next_move(positions[0].player_pieces, positions[0].opponent_pieces);
+
+    for (size_t i = 1; i < positions.size(); i++) {
+        const Position& pos = positions[i];
+        long before = allocation_count;
+        minimax.get_next_move(pos.player_pieces, pos.opponent_pieces);
+        long allocations = allocation_count - before;
+
+        int nodes = minimax.get_statistics()["search_count"];
+        std::cout << size.first << "x" << size.second << " depth " << depth << ": " << nodes
+                  << " nodes, " << allocations << " allocations" << std::endl;
+        if (allocations != 0 || nodes == 0)
+            failures++;
+    }
+    return failures;
+}
+
+int main()
+{
+    // The first position is the warm-up
+    std::vector<Position> positions = {
+        {{{6, 6}, {5, 7}}, {{6, 7}, {7, 6}}},
+        {{{6, 6}, {4, 5}, {4, 7}, {4, 6}, {5, 7}, {3, 7}, {3, 5}, {3, 6}, {3, 8}, {7, 7}},
+         {{5, 6}, {6, 5}, {8, 4}, {4, 4}, {4, 8}, {2, 7}, {2, 4}, {3, 4}, {3, 9}, {6, 7}}},
+        {{{5, 5}, {6, 6}, {7, 4}, {8, 6}}, {{6, 5}, {5, 6}, {7, 6}, {4, 4}}},
+        {{{6, 6}}, {{7, 7}}},
+    };
+
+    // A specialised board size and a runtime-sized one
+    int failures = check_board({12, 12}, 3, positions) + check_board({14, 14}, 3, positions);
+
+    std::cout << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include "minimax_algorithm.h"
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <chrono>
+
+/**
+ * Search options: principal variation search, aspiration windows and
+ * iterative deepening change how much is searched, not the result, so
+ * every combination must play the plain alpha-beta move on these
+ * positions; the re-search counters stay at zero when the switches are
+ * off, and threaded and time-budgeted searches still return legal moves.
+ * The selective switches (reductions, candidate cap, four extensions) may
+ * change the move, but must still block a four and report their work.
+ */
+struct Position {
+    std::vector<std::pair<int, int>> player_pieces;
+    std::vector<std::pair<int, int>> opponent_pieces;
+};
+
+static bool legal(const Position& pos, std::pair<int, int> move)
+{
+    if (move.first < 0 || move.first >= 12 || move.second < 0 || move.second >= 12)
+        return false;
+    for (const auto& pt : pos.player_pieces)
+        if (pt == move)
+            return false;
+    for (const auto& pt : pos.opponent_pieces)
+        if (pt == move)
+            return false;
+    return true;
+}
+
+int main()
+{
+    int failures = 0;
+    std::vector<Position> positions = {
+        {{{6, 6}, {5, 7}}, {{6, 7}, {7, 6}}},
+        {{{5, 5}, {5, 6}, {6, 7}, {7, 4}}, {{6, 6}, {4, 6}, {6, 5}, {7, 7}}},
+        {{{6, 6}, {7, 7}, {5, 8}, {8, 5}}, {{6, 7}, {7, 6}, {5, 7}, {8, 8}}},
+        {{{6, 6}, {4, 5}, {4, 7}, {4, 6}, {5, 7}, {3, 7}, {3, 5}, {3, 6}, {3, 8}, {7, 7}},
+         {{5, 6}, {6, 5}, {8, 4}, {4, 4}, {4, 8}, {2, 7}, {2, 4}, {3, 4}, {3, 9}, {6, 7}}},
+    };
+
+    for (size_t i = 0; i < positions.size(); i++) {
+        const auto& pos = positions[i];
+        MinimaxAlgorithm plain({12, 12}, 4, 1.0);
+        auto expected = plain.get_next_move(pos.player_pieces, pos.opponent_pieces);
+        auto stats = plain.get_statistics();
+        if (stats["pvs_researches"] != 0 || stats["aspiration_researches"] != 0) {
+            std::cout << "Position " << i << ": re-searches counted with the options off" << std::endl;
+            failures++;
+        }
+
+        for (int combination = 1; combination < 8; combination++) {
+            SearchOptions options;
+            options.principal_variation_search = (combination & 1) != 0;
+            options.aspiration_windows = (combination & 2) != 0;
+            options.iterative_deepening = (combination & 4) != 0;
+            MinimaxAlgorithm minimax({12, 12}, 4, 1.0, 1 << 16, 1, options);
+            auto move = minimax.get_next_move(pos.player_pieces, pos.opponent_pieces);
+            if (move != expected) {
+                std::cout << "Position " << i << ", options " << combination << ": got (" << move.first << ", "
+                          << move.second << "), expected (" << expected.first << ", " << expected.second << ")"
+                          << std::endl;
+                failures++;
+            }
+        }
+
+        SearchOptions all;
+        all.principal_variation_search = true;
+        all.aspiration_windows = true;
+        MinimaxAlgorithm threaded({12, 12}, 4, 1.0, 1 << 16, 2, all);
+        MinimaxAlgorithm timed({12, 12}, 4, 1.0, 1 << 16, 1, all);
+        if (!legal(pos, threaded.get_next_move(pos.player_pieces, pos.opponent_pieces)) ||
+            !legal(pos, timed.get_next_move(pos.player_pieces, pos.opponent_pieces, std::chrono::milliseconds(100)))) {
+            std::cout << "Position " << i << ": illegal move from a threaded or timed search" << std::endl;
+            failures++;
+        }
+    }
+
+    // Selective search: the block of the opponent's four survives every
+    // switch, and each switch shows up in its counter on a quiet position
+    Position four = {{{3, 2}, {6, 6}, {7, 7}, {8, 5}}, {{3, 3}, {3, 4}, {3, 5}, {3, 6}, {5, 7}}};
+    const auto& quiet = positions[3];
+    for (int combination = 1; combination < 8; combination++) {
+        SearchOptions options;
+        options.late_move_reductions = (combination & 1) != 0;
+        options.candidate_cap = (combination & 2) != 0;
+        options.four_extensions = (combination & 4) != 0;
+        MinimaxAlgorithm minimax({12, 12}, 4, 1.0, 1 << 16, 1, options);
+        auto move = minimax.get_next_move(four.player_pieces, four.opponent_pieces);
+        if (move != std::make_pair(3, 7)) {
+            std::cout << "Selective options " << combination << ": four not blocked, got (" << move.first << ", "
+                      << move.second << ")" << std::endl;
+            failures++;
+        }
+
+        MinimaxAlgorithm plain({12, 12}, 4, 1.0);
+        plain.get_next_move(quiet.player_pieces, quiet.opponent_pieces);
+        minimax.get_next_move(quiet.player_pieces, quiet.opponent_pieces);
+        auto stats = minimax.get_statistics();
+        if ((stats["reductions"] > 0) != options.late_move_reductions ||
+            (stats["extensions"] > 0) != options.four_extensions ||
+            (options.candidate_cap && !options.four_extensions &&
+             stats["search_count"] >= plain.get_statistics()["search_count"])) {
+            std::cout << "Selective options " << combination << ": counters " << stats["reductions"] << " reductions, "
+                      << stats["extensions"] << " extensions, " << stats["search_count"] << " nodes" << std::endl;
+            failures++;
+        }
+    }
+
+    std::cout << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#include "minimax_algorithm.h"
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <chrono>
+
+/**
+ * Game session API: a freshly set up session must search exactly like the
+ * stateless get_next_move, apply_move/undo_move must keep the board
+ * consistent, and over a game the session must keep producing legal
+ * moves while reusing the previous principal variation. With nothing to
+ * search, a won game or a full board, the answer is {-1, -1}; an empty
+ * board opens in the centre, and a lost position still gets a legal move.
+ */
+int main()
+{
+    int failures = 0;
+    std::vector<std::pair<int, int>> player = {{6, 6}, {4, 5}, {4, 7}, {4, 6}, {5, 7}, {3, 7}, {3, 5}, {3, 6}, {3, 8}, {7, 7}};
+    std::vector<std::pair<int, int>> opponent = {{5, 6}, {6, 5}, {8, 4}, {4, 4}, {4, 8}, {2, 7}, {2, 4}, {3, 4}, {3, 9}, {6, 7}};
+
+    // Same position set up both ways
+    MinimaxAlgorithm stateless({12, 12}, 3, 1.0);
+    MinimaxAlgorithm session({12, 12}, 3, 1.0);
+    auto expected = stateless.get_next_move(player, opponent);
+    for (size_t i = 0; i < player.size(); i++) {
+        session.apply_move(0, player[i]);
+        session.apply_move(1, opponent[i]);
+    }
+    auto actual = session.get_next_move();
+    if (actual != expected ||
+        session.get_statistics()["search_count"] != stateless.get_statistics()["search_count"]) {
+        std::cout << "Session search differs from the stateless one" << std::endl;
+        failures++;
+    }
+
+    // Illegal moves are refused, undo takes stones back in order
+    if (session.apply_move(0, player[0]) || session.apply_move(1, {12, 0}) || session.apply_move(2, {0, 0})) {
+        std::cout << "Illegal move accepted" << std::endl;
+        failures++;
+    }
+    std::vector<std::pair<int, int>> extra = {{0, 0}, {11, 11}, {0, 11}};
+    for (size_t i = 0; i < extra.size(); i++)
+        session.apply_move(i % 2, extra[i]);
+    for (size_t i = 0; i < extra.size(); i++)
+        session.undo_move();
+    for (const auto& pt : extra) {
+        if (!session.apply_move(0, pt) || !session.undo_move()) {
+            std::cout << "Cell (" << pt.first << ", " << pt.second << ") not freed by undo" << std::endl;
+            failures++;
+        }
+    }
+    int undone = 0;
+    while (session.undo_move())
+        undone++;
+    if (undone != static_cast<int>(player.size() + opponent.size())) {
+        std::cout << "Undid " << undone << " stones" << std::endl;
+        failures++;
+    }
+
+    // A game against a stateless opponent
+    MinimaxAlgorithm rival({12, 12}, 3, 1.0);
+    std::vector<std::pair<int, int>> ai = {{6, 6}}, other = {{6, 7}};
+    session.new_game();
+    session.apply_move(0, ai[0]);
+    session.apply_move(1, other[0]);
+    int reused = 0;
+    for (int turn = 0; turn < 10; turn++) {
+        auto move = session.get_next_move();
+        reused += session.get_statistics()["pv_reused"] > 0;
+        if (!session.apply_move(0, move)) {
+            std::cout << "Turn " << turn << ": illegal move (" << move.first << ", " << move.second << ")" << std::endl;
+            failures++;
+            break;
+        }
+        ai.push_back(move);
+        auto reply = rival.get_next_move(other, ai);
+        other.push_back(reply);
+        session.apply_move(1, reply);
+    }
+    if (reused == 0) {
+        std::cout << "The principal variation was never reused" << std::endl;
+        failures++;
+    }
+
+    // Nothing to search: {-1, -1}, not the move of the previous search
+    session.new_game();
+    session.apply_move(0, {6, 6});
+    session.apply_move(1, {6, 7});
+    session.get_next_move();
+    session.new_game();
+    for (int y = 2; y < 7; y++) {
+        session.apply_move(0, {9, y});
+        session.apply_move(1, {3, y});
+    }
+    auto won = session.get_next_move();
+    auto won_timed = session.get_next_move(std::chrono::milliseconds(50));
+    if (won != std::make_pair(-1, -1) || won_timed != std::make_pair(-1, -1)) {
+        std::cout << "Move (" << won.first << ", " << won.second << ") after the game was won" << std::endl;
+        failures++;
+    }
+    
+    // An empty board opens in the centre
+    session.new_game();
+    auto opening = session.get_next_move();
+    auto opening_timed = session.get_next_move(std::chrono::milliseconds(50));
+    if (opening != std::make_pair(6, 6) || opening_timed != std::make_pair(6, 6)) {
+        std::cout << "Move (" << opening.first << ", " << opening.second << ") on the empty board" << std::endl;
+        failures++;
+    }
+
+    // A lost position, the opponent having an open four: with a high
+    // attack ratio every root move scores at or below -infinity, and a
+    // legal move must still come back
+    MinimaxAlgorithm lost({12, 12}, 4, 10.0);
+    for (int y = 3; y < 7; y++)
+        lost.apply_move(1, {3, y});
+    for (const auto& pt : std::vector<std::pair<int, int>>{{8, 8}, {9, 10}, {10, 8}, {0, 11}})
+        lost.apply_move(0, pt);
+    for (int timed = 0; timed < 2; timed++) {
+        auto move = timed ? lost.get_next_move(std::chrono::milliseconds(50)) : lost.get_next_move();
+        if (!lost.apply_move(0, move)) {
+            std::cout << "Illegal move (" << move.first << ", " << move.second << ") in a lost position" << std::endl;
+            failures++;
+        } else {
+            lost.undo_move();
+        }
+    }
+
+    // A full board without a five: stones in runs of at most two along
+    // every line
+    session.new_game();
+    for (int x = 0; x < 12; x++) {
+        for (int y = 0; y < 12; y++) {
+            session.apply_move((x + 2 * y) % 4 < 2 ? 0 : 1, {x, y});
+        }
+    }
+    auto full = session.get_next_move();
+    if (full != std::make_pair(-1, -1)) {
+        std::cout << "Move (" << full.first << ", " << full.second << ") on a full board" << std::endl;
+        failures++;
+    }
+
+    std::cout << reused << " turns reused the PV, " << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+#include "minimax_algorithm.h"
+#include "board_symmetry.h"
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <random>
+
+/**
+ * Symmetric position keys: the incrementally kept key of every symmetry
+ * matches a full recomputation, and a session whose transposition table
+ * was filled by other orientations of a position takes their moves as
+ * hints only, answering as a fresh search of that orientation would.
+ */
+int main()
+{
+    int failures = 0;
+
+    // Random games on a square and a rectangular board
+    for (auto size : std::vector<std::pair<int, int>>{{15, 15}, {12, 9}}) {
+        int columns = size.first, rows = size.second;
+        ZobristKeys zobrist;
+        zobrist.reset(columns * rows);
+        SymmetricKeys keys;
+        keys.reset(columns, rows);
+        Bitboard board(columns, rows);
+        std::mt19937 rng(columns * 31 + rows);
+
+        for (int s = 0; s < keys.count(); s++) {
+            for (int cell = 0; cell < columns * rows; cell++) {
+                auto mapped = apply_symmetry(s, cell / rows, cell % rows, columns, rows);
+                if (keys.map_cell(s, cell) != mapped.first * rows + mapped.second) {
+                    std::cout << "Symmetry " << s << " maps cell " << cell << " wrongly" << std::endl;
+                    failures++;
+                }
+            }
+        }
+
+        for (int game = 0; game < 20; game++) {
+            board.clear();
+            keys.clear();
+            for (int stone = 0; stone < 40; stone++) {
+                int x = rng() % columns, y = rng() % rows;
+                if (board.occupied(x, y))
+                    continue;
+                board.make(stone % 2, x, y);
+                keys.toggle(zobrist, stone % 2, board.index(x, y));
+
+                int expected_symmetry, symmetry;
+                uint64_t expected = canonical_key(board, zobrist, expected_symmetry);
+                if (keys.canonical(symmetry) != expected || symmetry != expected_symmetry) {
+                    std::cout << columns << "x" << rows << " game " << game << ": canonical key differs" << std::endl;
+                    failures++;
+                }
+            }
+            // Taking every stone back returns to the empty key
+            for (int side = 0; side < 2; side++)
+                for (const auto& pt : board.pieces(side))
+                    keys.toggle(zobrist, side, board.index(pt.first, pt.second));
+            for (int s = 0; s < keys.count(); s++) {
+                if (keys.key(s) != 0) {
+                    std::cout << "Key " << s << " not cleared by removing the stones" << std::endl;
+                    failures++;
+                }
+            }
+        }
+    }
+
+    // Positions played in each orientation in turn, in one session and in
+    // a fresh one. The table is keyed by the exact position, so the
+    // entries left by the other orientations may only reorder the moves:
+    // both sessions must answer alike. A position won by a VCF at the root
+    // is not searched at all
+    const int size = 12;
+    std::vector<std::vector<std::pair<int, int>>> players = {
+        {{6, 6}, {4, 5}, {4, 7}, {4, 6}, {5, 7}, {3, 7}, {3, 5}, {3, 6}, {3, 8}, {7, 7}}};
+    std::vector<std::vector<std::pair<int, int>>> opponents = {
+        {{5, 6}, {6, 5}, {8, 4}, {4, 4}, {4, 8}, {2, 7}, {2, 4}, {3, 4}, {3, 9}, {6, 7}}};
+    std::mt19937 rng(size);
+    while (players.size() < 4) {
+        // Four stones a side near the centre cannot make a five
+        std::vector<std::pair<int, int>> cells;
+        for (int x = 4; x < 9; x++) {
+            for (int y = 4; y < 9; y++) {
+                cells.push_back({x, y});
+            }
+        }
+        std::shuffle(cells.begin(), cells.end(), rng);
+        players.push_back({cells.begin(), cells.begin() + 4});
+        opponents.push_back({cells.begin() + 4, cells.begin() + 8});
+    }
+    
+    MinimaxAlgorithm session({size, size}, 4, 1.0);
+    for (size_t position = 0; position < players.size(); position++) {
+        const auto& player = players[position];
+        const auto& opponent = opponents[position];
+        for (int s = 0; s < 8; s++) {
+            std::vector<std::pair<int, int>> p, o;
+            for (size_t i = 0; i < player.size(); i++) {
+                p.push_back(apply_symmetry(s, player[i].first, player[i].second, size, size));
+                o.push_back(apply_symmetry(s, opponent[i].first, opponent[i].second, size, size));
+            }
+            while (session.undo_move()) {
+            }
+            for (size_t i = 0; i < p.size(); i++) {
+                session.apply_move(0, p[i]);
+                session.apply_move(1, o[i]);
+            }
+            auto move = session.get_next_move();
+            auto stats = session.get_statistics();
+            
+            MinimaxAlgorithm fresh({size, size}, 4, 1.0);
+            auto expected = fresh.get_next_move(p, o);
+            if (move != expected) {
+                std::cout << "Position " << position << ", symmetry " << s << ": got (" << move.first << ", "
+                          << move.second << "), a fresh search (" << expected.first << ", " << expected.second
+                          << ")" << std::endl;
+                failures++;
+            }
+            if (s > 0 && stats["search_count"] > 0 && stats["tt_symmetry_moves"] == 0) {
+                std::cout << "Position " << position << ", symmetry " << s
+                          << " took no moves from the other orientations" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    std::cout << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include "bitboard.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/**
+ * Regression test: the last-move win check must agree with the
+ * full-board check_win scan on random positions.
+ */
+int main()
+{
+    std::mt19937 rng(12345);
+    int failures = 0;
+    int wins = 0;
+
+    for (int size : {12, 13, 15}) {
+        Bitboard board(size, size);
+        std::vector<std::pair<int, int>> cells;
+        for (int x = 0; x < size; x++)
+            for (int y = 0; y < size; y++)
+                cells.push_back({x, y});
+
+        for (int game = 0; game < 500; game++) {
+            board.clear();
+            std::shuffle(cells.begin(), cells.end(), rng);
+
+            // Play random stones until someone completes a five
+            for (size_t k = 0; k < cells.size(); k++) {
+                int side = k % 2;
+                const auto& pt = cells[k];
+                board.make(side, pt.first, pt.second);
+
+                bool full = board.check_win(side);
+                bool last = board.check_win_at(side, pt.first, pt.second);
+                if (full != last) {
+                    std::cout << "Mismatch on " << size << "x" << size << " game " << game
+                              << " move (" << pt.first << ", " << pt.second << ")" << std::endl;
+                    failures++;
+                }
+                if (full) {
+                    wins++;
+                    break;
+                }
+                if (board.check_win(1 - side)) {
+                    std::cout << "Opponent five appeared without a move" << std::endl;
+                    failures++;
+                }
+            }
+
+            // Every stone of a finished position: any last-move five
+            // must also be seen by the full scan
+            for (int side = 0; side < 2; side++) {
+                bool any = false;
+                for (const auto& pt : board.pieces(side))
+                    any = any || board.check_win_at(side, pt.first, pt.second);
+                if (any != board.check_win(side)) {
+                    std::cout << "Per-stone check disagrees with full scan" << std::endl;
+                    failures++;
+                }
+            }
+        }
+    }
+
+    std::cout << wins << " finished games checked, " << failures << " failures." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include "threat_search.h"
+
+static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+bool ThreatSearch::makes_five(const Bitboard& board, int side, int x, int y) {
+    for (const auto& d : directions) {
+        int count = 1;
+        for (int k = 1; k < 5 && board.has(side, x + k * d[0], y + k * d[1]); k++) {
+            count++;
+        }
+        for (int k = 1; k < 5 && board.has(side, x - k * d[0], y - k * d[1]); k++) {
+            count++;
+        }
+        if (count >= 5) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cells that would complete a five after a `side` stone on (x, y), i.e.
+// the gaps of every four it makes. Stops at two: two gaps cannot both be
+// blocked.
+int ThreatSearch::completing_cells(const Bitboard& board, int side, int x, int y,
+                                   std::pair<int, int> out[2]) const {
+    int count = 0;
+    for (const auto& d : directions) {
+        // Five-cell windows along d that contain (x, y)
+        for (int start = -4; start <= 0; start++) {
+            int own = 0;
+            std::pair<int, int> gap = {-1, -1};
+            bool blocked = false;
+            for (int k = start; k < start + 5 && !blocked; k++) {
+                int cx = x + k * d[0];
+                int cy = y + k * d[1];
+                if (k == 0 || board.has(side, cx, cy)) {
+                    own++;
+                } else if (!board.in_bounds(cx, cy) || board.occupied(cx, cy) || gap.first >= 0) {
+                    blocked = true;
+                } else {
+                    gap = {cx, cy};
+                }
+            }
+            if (blocked || own != 4) {
+                continue;
+            }
+            if (count == 1 && out[0] == gap) {
+                continue;
+            }
+            out[count++] = gap;
+            if (count == 2) {
+                return count;
+            }
+        }
+    }
+    return count;
+}
+
+bool ThreatSearch::find_vcf(Bitboard& board, CandidateSet& cells, int attacker, int max_fours, int node_limit,
+                            std::vector<std::pair<int, int>>& line) {
+    node_count = 0;
+    node_budget = node_limit;
+    line.clear();
+    // Per-ply cell lists keep their capacity between calls, so the leaf
+    // searches inside negamax do not allocate
+    if (static_cast<int>(cell_lists.size()) < max_fours + 1) {
+        cell_lists.resize(max_fours + 1);
+        for (auto& list : cell_lists) {
+            list.reserve(cells.cell_count());
+        }
+        line.reserve(2 * max_fours + 3);
+    }
+    return vcf(board, cells, attacker, max_fours, 0, line);
+}
+
+bool ThreatSearch::vcf(Bitboard& board, CandidateSet& cells, int attacker, int fours_left, int ply,
+                       std::vector<std::pair<int, int>>& line) {
+    if (++node_count > node_budget) {
+        return false;
+    }
+    int defender = 1 - attacker;
+
+    auto& moves = cell_lists[ply];
+    moves.clear();
+    cells.collect(moves);
+
+    // A five now wins; otherwise a five threat from the defender has to be
+    // answered, which is no longer a continuous-four sequence
+    for (const auto& pt : moves) {
+        if (makes_five(board, attacker, pt.first, pt.second)) {
+            line.push_back(pt);
+            return true;
+        }
+    }
+    for (const auto& pt : moves) {
+        if (makes_five(board, defender, pt.first, pt.second)) {
+            return false;
+        }
+    }
+    if (fours_left == 0) {
+        return false;
+    }
+
+    for (const auto& pt : moves) {
+        std::pair<int, int> gaps[2];
+        int gap_count = completing_cells(board, attacker, pt.first, pt.second, gaps);
+        if (gap_count == 0) {
+            continue;
+        }
+
+        // An open four or a double four: the defender cannot stop both
+        if (gap_count == 2) {
+            line.push_back(pt);
+            line.push_back(gaps[0]);
+            line.push_back(gaps[1]);
+            return true;
+        }
+
+        // A single four: the defender must block its gap
+        board.make(attacker, pt.first, pt.second);
+        cells.add_stone(pt.first, pt.second);
+        board.make(defender, gaps[0].first, gaps[0].second);
+        cells.add_stone(gaps[0].first, gaps[0].second);
+
+        line.push_back(pt);
+        line.push_back(gaps[0]);
+        bool win = vcf(board, cells, attacker, fours_left - 1, ply + 1, line);
+
+        cells.remove_stone(gaps[0].first, gaps[0].second);
+        board.unmake(defender, gaps[0].first, gaps[0].second);
+        cells.remove_stone(pt.first, pt.second);
+        board.unmake(attacker, pt.first, pt.second);
+
+        if (win) {
+            return true;
+        }
+        line.pop_back();
+        line.pop_back();
+        if (node_count > node_budget) {
+            return false;
+        }
+    }
+    return false;
+}
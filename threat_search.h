@@ -0,0 +1,41 @@
+#ifndef THREAT_SEARCH_H
+#define THREAT_SEARCH_H
+
+#include <vector>
+#include <utility>
+#include "bitboard.h"
+#include "candidate_set.h"
+
+// Threat-space search for forced wins by continuous fours (VCF).
+//
+// Only the attacker's fours are tried, and the defender's only answer to a
+// four is to block its completing cell, so the tree is a small fraction of
+// a full-width search. Every stone of a four lies within distance 2 of
+// another stone, so moves come from a radius-2 CandidateSet.
+class ThreatSearch {
+public:
+    // Search for a VCF for `attacker`, who is to move. At most `max_fours`
+    // fours are played and `node_limit` nodes visited. On success `line`
+    // holds the forced sequence (attacker, defender, attacker, ...) ending
+    // with the winning stone, or with an open/double four followed by its
+    // two completing cells. The board and set are restored on return.
+    bool find_vcf(Bitboard& board, CandidateSet& cells, int attacker, int max_fours, int node_limit,
+                  std::vector<std::pair<int, int>>& line);
+
+    // Nodes visited by the last find_vcf call
+    int nodes() const { return node_count; }
+
+    // True if a stone for `side` on the empty cell (x, y) makes five
+    static bool makes_five(const Bitboard& board, int side, int x, int y);
+
+private:
+    int node_count;
+    int node_budget;
+    std::vector<std::vector<std::pair<int, int>>> cell_lists;    // scratch per ply
+
+    bool vcf(Bitboard& board, CandidateSet& cells, int attacker, int fours_left, int ply,
+             std::vector<std::pair<int, int>>& line);
+    int completing_cells(const Bitboard& board, int side, int x, int y, std::pair<int, int> out[2]) const;
+};
+
+#endif // THREAT_SEARCH_H
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <utility>
+#include <cstdlib>
+#include "minimax_algorithm.h"
+#include "board_symmetry.h"
+#include "opening_book.h"
+
+/**
+ * Offline opening book builder. Starting from the empty board and a first
+ * stone in the centre, every position reachable by playing next to an
+ * existing stone is enumerated up to `max_stones` stones, one per symmetry
+ * class, and searched at `depth` to get its book move. The board is
+ * 12x12 unless `size` says otherwise; a book is only loaded by an engine
+ * of the same size.
+ *
+ * Usage: gobang_book_builder <output> [size] [max_stones] [depth]
+ */
+struct Position {
+    std::vector<std::pair<int, int>> first;     // stones of the player who opened
+    std::vector<std::pair<int, int>> second;
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <output> [size] [max_stones] [depth]" << std::endl;
+        return 1;
+    }
+    std::string output = argv[1];
+    int size = argc > 2 ? atoi(argv[2]) : 12;
+    int max_stones = argc > 3 ? atoi(argv[3]) : 3;
+    int depth = argc > 4 ? atoi(argv[4]) : 5;
+
+    MinimaxAlgorithm minimax({size, size}, depth, 1.0, 1 << 20);
+    ZobristKeys keys;
+    keys.reset(size * size);
+    Bitboard board(size, size);
+
+    std::vector<BookEntry> entries;
+    std::set<uint64_t> seen;
+    std::vector<Position> level(1);
+
+    for (int stones = 0; stones <= max_stones && !level.empty(); stones++) {
+        std::vector<Position> next_level;
+        for (const auto& pos : level) {
+            // The side to move is side 0 in the book's keys
+            bool first_to_move = stones % 2 == 0;
+            const auto& mover = first_to_move ? pos.first : pos.second;
+            const auto& other = first_to_move ? pos.second : pos.first;
+            board.clear();
+            for (const auto& pt : mover)
+                board.make(0, pt.first, pt.second);
+            for (const auto& pt : other)
+                board.make(1, pt.first, pt.second);
+
+            int symmetry;
+            uint64_t key = canonical_key(board, keys, symmetry);
+            if (!seen.insert(key).second)
+                continue;
+
+            std::pair<int, int> move = minimax.get_next_move(mover, other);
+            auto canonical = apply_symmetry(symmetry, move.first, move.second, size, size);
+            entries.push_back({key, static_cast<uint16_t>(board.index(canonical.first, canonical.second)),
+                               static_cast<uint16_t>(depth)});
+
+            if (stones == max_stones)
+                continue;
+
+            // Children: the mover plays next to a stone (the first stone
+            // goes in the centre)
+            for (int x = 0; x < size; x++) {
+                for (int y = 0; y < size; y++) {
+                    bool near = stones == 0 ? (x == size / 2 && y == size / 2) : false;
+                    for (int dx = -1; dx <= 1 && !near; dx++)
+                        for (int dy = -1; dy <= 1 && !near; dy++)
+                            near = board.occupied(x + dx, y + dy);
+                    if (!near || board.occupied(x, y))
+                        continue;
+                    Position child = pos;
+                    (first_to_move ? child.first : child.second).push_back({x, y});
+                    next_level.push_back(child);
+                }
+            }
+        }
+        std::cout << "stones " << stones << ": " << entries.size() << " book positions" << std::endl;
+        level.swap(next_level);
+    }
+
+    if (!write_opening_book(output, size, size, entries)) {
+        std::cerr << "Cannot write " << output << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << entries.size() << " positions to " << output << std::endl;
+    return 0;
+}
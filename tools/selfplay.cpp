@@ -0,0 +1,225 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include "minimax_algorithm.h"
+#include "bitboard.h"
+
+/**
+ * Self-play match between two engine settings, the acceptance test for
+ * search changes. Each game starts from a random opening of four stones
+ * near the centre, played once with each setting moving first, and the
+ * engines then alternate until a five or a full board. Game pairs can be
+ * played on several threads, each with its own pair of engines.
+ *
+ * Prints the result of every game pair, then the score of setting b with
+ * a 95% confidence interval and the Elo difference it implies, and the
+ * average ms/move and nodes/s (search_count per second) of each side.
+ *
+ * A setting is a comma-separated list: depth=N or time=MS (a time budget
+ * per move instead of a fixed depth), ratio=R (attack ratio), and the
+ * search options pvs, asp, id, lmr, cap, ext, with limit=K for the
+ * candidate cap.
+ *
+ * Usage: gobang_selfplay [games] [setting_a] [setting_b] [size] [seed] [threads]
+ */
+struct Setting {
+    std::string text;
+    int depth = 5;
+    int time_ms = 0;
+    double ratio = 1.0;
+    SearchOptions options;
+};
+
+// Moves, nodes and search time of one side over a game
+struct SideTotals {
+    long long moves = 0;
+    long long nodes = 0;
+    double ms = 0;
+};
+
+struct GameResult {
+    int first;      // setting that moved first
+    int winner;     // 0 for a, 1 for b, -1 for a draw
+    SideTotals sides[2];
+};
+
+static bool parse_setting(const std::string& text, Setting& setting)
+{
+    setting.text = text;
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        std::string key = item.substr(0, item.find('='));
+        const char* value = item.find('=') == std::string::npos ? "0" : item.c_str() + item.find('=') + 1;
+        if (key == "depth")
+            setting.depth = atoi(value);
+        else if (key == "time")
+            setting.time_ms = atoi(value);
+        else if (key == "ratio")
+            setting.ratio = atof(value);
+        else if (key == "limit")
+            setting.options.candidate_limit = atoi(value);
+        else if (key == "pvs")
+            setting.options.principal_variation_search = true;
+        else if (key == "asp")
+            setting.options.aspiration_windows = true;
+        else if (key == "id")
+            setting.options.iterative_deepening = true;
+        else if (key == "lmr")
+            setting.options.late_move_reductions = true;
+        else if (key == "cap")
+            setting.options.candidate_cap = true;
+        else if (key == "ext")
+            setting.options.four_extensions = true;
+        else
+            return false;
+    }
+    return setting.depth > 0;
+}
+
+// Play one game between engines[0] (setting a) and engines[1] (setting b)
+static GameResult play_game(MinimaxAlgorithm* engines[2], const Setting* settings[2], int size,
+                            const std::vector<std::pair<int, int>>& opening, int first)
+{
+    GameResult result;
+    result.first = first;
+    result.winner = -1;
+    Bitboard board(size, size);
+    for (int e = 0; e < 2; e++)
+        engines[e]->new_game();
+
+    // Opening stones alternate starting with the engine that moves first;
+    // each engine is player 0 on its own board
+    int mover = first;
+    auto play = [&](std::pair<int, int> move) {
+        board.make(mover == first ? 0 : 1, move.first, move.second);
+        engines[mover]->apply_move(0, move);
+        engines[1 - mover]->apply_move(1, move);
+        mover = 1 - mover;
+    };
+    for (const auto& move : opening)
+        play(move);
+
+    while (board.count(0) + board.count(1) < size * size) {
+        auto start = std::chrono::steady_clock::now();
+        std::pair<int, int> move = settings[mover]->time_ms > 0
+            ? engines[mover]->get_next_move(std::chrono::milliseconds(settings[mover]->time_ms))
+            : engines[mover]->get_next_move();
+        SideTotals& side = result.sides[mover];
+        side.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        side.nodes += engines[mover]->get_statistics()["search_count"];
+        side.moves++;
+
+        if (!board.in_bounds(move.first, move.second) || board.occupied(move.first, move.second)) {
+            result.winner = 1 - mover;
+            break;
+        }
+        int player = mover;
+        play(move);
+        if (board.check_win(player == first ? 0 : 1)) {
+            result.winner = player;
+            break;
+        }
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    int games = argc > 1 ? atoi(argv[1]) : 20;
+    Setting a, b;
+    if (games < 1 ||
+        !parse_setting(argc > 2 ? argv[2] : "depth=5", a) ||
+        !parse_setting(argc > 3 ? argv[3] : "depth=5,lmr,cap,ext", b)) {
+        std::cerr << "Usage: " << argv[0] << " [games] [setting_a] [setting_b] [size] [seed] [threads]" << std::endl;
+        return 1;
+    }
+    int size = argc > 4 ? atoi(argv[4]) : 15;
+    unsigned seed = argc > 5 ? static_cast<unsigned>(atoi(argv[5])) : 1;
+    int threads = argc > 6 ? std::max(atoi(argv[6]), 1) : 1;
+
+    // Openings are drawn up front so the games do not depend on threads:
+    // four stones at distinct cells within two of the centre
+    std::mt19937 rng(seed);
+    int pairs = (games + 1) / 2;
+    std::vector<std::vector<std::pair<int, int>>> openings(pairs);
+    for (auto& opening : openings) {
+        while (opening.size() < 4) {
+            std::pair<int, int> cell(size / 2 - 2 + static_cast<int>(rng() % 5),
+                                     size / 2 - 2 + static_cast<int>(rng() % 5));
+            bool taken = false;
+            for (const auto& pt : opening)
+                taken = taken || pt == cell;
+            if (!taken)
+                opening.push_back(cell);
+        }
+    }
+
+    // Each thread takes the next game off the list with its own engines
+    std::vector<GameResult> results(games);
+    std::atomic<int> next_game(0);
+    auto work = [&]() {
+        MinimaxAlgorithm engine_a({size, size}, a.depth, a.ratio, 1 << 18, 1, a.options);
+        MinimaxAlgorithm engine_b({size, size}, b.depth, b.ratio, 1 << 18, 1, b.options);
+        MinimaxAlgorithm* engines[2] = {&engine_a, &engine_b};
+        const Setting* settings[2] = {&a, &b};
+        for (int game = next_game++; game < games; game = next_game++)
+            results[game] = play_game(engines, settings, size, openings[game / 2], game % 2);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.emplace_back(work);
+    work();
+    for (auto& worker : pool)
+        worker.join();
+
+    // Wins for a and b, draws, and per-side totals
+    int score[3] = {0, 0, 0};
+    SideTotals totals[2];
+    for (int game = 0; game < games; game++) {
+        const GameResult& result = results[game];
+        if (game % 2 == 0)
+            std::cout << "opening " << game / 2 + 1 << ":";
+        std::cout << " " << (result.first == 0 ? "a" : "b") << " first: "
+                  << (result.winner < 0 ? "draw" : result.winner == 0 ? "a wins" : "b wins")
+                  << (game % 2 == 0 && game + 1 < games ? "," : "\n");
+        score[result.winner < 0 ? 2 : result.winner]++;
+        for (int side = 0; side < 2; side++) {
+            totals[side].moves += result.sides[side].moves;
+            totals[side].nodes += result.sides[side].nodes;
+            totals[side].ms += result.sides[side].ms;
+        }
+    }
+
+    // Score of b per game is 1, 1/2 or 0; the interval is the normal
+    // approximation from the spread of those per-game scores
+    double mean = (score[1] + 0.5 * score[2]) / games;
+    double variance = (score[1] * (1 - mean) * (1 - mean) + score[2] * (0.5 - mean) * (0.5 - mean) +
+                       score[0] * mean * mean) / games;
+    double margin = 1.96 * std::sqrt(variance / games);
+    auto elo = [](double p) {
+        p = std::min(std::max(p, 0.001), 0.999);
+        return -400 * std::log10(1 / p - 1);
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "a (" << a.text << ") " << score[0] << " - " << score[1] << " b (" << b.text << "), "
+              << score[2] << " draws" << std::endl;
+    std::cout << "b scores " << 100 * mean << "% +- " << 100 * margin << "% (95%), Elo " << elo(mean) << " ["
+              << elo(mean - margin) << ", " << elo(mean + margin) << "]" << std::endl;
+    for (int side = 0; side < 2; side++) {
+        const SideTotals& t = totals[side];
+        std::cout << (side == 0 ? "a" : "b") << ": " << t.moves << " moves, "
+                  << (t.moves > 0 ? t.ms / t.moves : 0) << " ms/move, "
+                  << static_cast<long long>(t.ms > 0 ? t.nodes / (t.ms / 1000) : 0) << " nodes/s" << std::endl;
+    }
+    return 0;
+}
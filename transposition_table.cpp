@@ -0,0 +1,94 @@
+#include "transposition_table.h"
+
+// splitmix64 step, used to fill the key table
+static uint64_t next_key(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void ZobristKeys::reset(int cells) {
+    uint64_t state = 0x5EED5EED5EED5EEDULL;
+    cell_count = cells;
+    keys.resize(2 * cells);
+    for (auto& key : keys) {
+        key = next_key(state);
+    }
+    side_key = next_key(state);
+}
+
+// Packed entry: score in bits 0-31, move in 32-47, depth + 1 in 48-55
+// (0 marks an empty slot) and the bound in 56-63
+static uint64_t pack(const TTEntry& entry) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(entry.score)) |
+           static_cast<uint64_t>(static_cast<uint16_t>(entry.move)) << 32 |
+           static_cast<uint64_t>(static_cast<uint8_t>(entry.depth + 1)) << 48 |
+           static_cast<uint64_t>(entry.bound) << 56;
+}
+
+static TTEntry unpack(uint64_t data) {
+    TTEntry entry;
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    entry.move = static_cast<int16_t>(static_cast<uint16_t>(data >> 32));
+    entry.depth = static_cast<int8_t>(static_cast<uint8_t>(data >> 48) - 1);
+    entry.bound = static_cast<uint8_t>(data >> 56);
+    return entry;
+}
+
+TranspositionTable::TranspositionTable(std::size_t entries) {
+    resize(entries);
+}
+
+void TranspositionTable::resize(std::size_t entries) {
+    std::size_t size = 0;
+    if (entries > 0) {
+        size = 1;
+        while (size * 2 <= entries) {
+            size *= 2;
+        }
+    }
+    table = std::vector<Slot>(size);
+    slot_count = size;
+    mask = size > 0 ? size - 1 : 0;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (auto& slot : table) {
+        slot.check.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    if (slot_count == 0) {
+        return false;
+    }
+    const Slot& slot = table[key & mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((data >> 48 & 0xFF) == 0 || (check ^ data) != key) {
+        return false;
+    }
+    entry = unpack(data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, TTBound bound, int score, int move) {
+    if (slot_count == 0) {
+        return;
+    }
+    Slot& slot = table[key & mask];
+    uint64_t old_data = slot.data.load(std::memory_order_relaxed);
+    uint64_t old_key = slot.check.load(std::memory_order_relaxed) ^ old_data;
+    int old_depth = static_cast<int>(old_data >> 48 & 0xFF) - 1;
+    if (old_key != key && old_depth > depth) {
+        return;
+    }
+
+    TTEntry entry = {score, static_cast<int16_t>(move), static_cast<int8_t>(depth), bound};
+    uint64_t data = pack(entry);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
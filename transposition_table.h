@@ -0,0 +1,70 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Random 64-bit keys for Zobrist hashing: one per (side, cell) plus one
+// for the side to move. Keys come from a fixed seed so hashes are
+// reproducible between runs.
+class ZobristKeys {
+public:
+    void reset(int cell_count);
+
+    uint64_t stone(int side, int cell) const { return keys[side * cell_count + cell]; }
+    uint64_t side_to_move() const { return side_key; }
+
+private:
+    int cell_count;
+    uint64_t side_key;
+    std::vector<uint64_t> keys;
+};
+
+// Bound type of a stored score
+enum TTBound : uint8_t {
+    TT_EXACT = 0,
+    TT_LOWER = 1,   // score >= stored (fail high)
+    TT_UPPER = 2    // score <= stored (fail low)
+};
+
+struct TTEntry {
+    int32_t score;
+    int16_t move;   // cell index of the best move, -1 if none
+    int8_t depth;
+    uint8_t bound;
+};
+
+// Fixed-size, always-indexed transposition table. The entry count is
+// rounded down to a power of two; 0 disables the table.
+//
+// Each slot is two 64-bit words, the packed entry and key ^ entry, so
+// several search threads can share the table without locks: a slot torn
+// by a concurrent write fails the key check and reads as a miss.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(std::size_t entries = 0);
+
+    void resize(std::size_t entries);
+    void clear();
+    std::size_t size() const { return slot_count; }
+
+    // True and fills `entry` if `key` is stored
+    bool probe(uint64_t key, TTEntry& entry) const;
+
+    // Replace unless the slot holds a deeper result for another position
+    void store(uint64_t key, int depth, TTBound bound, int score, int move);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;    // key ^ data
+        std::atomic<uint64_t> data;
+    };
+
+    std::vector<Slot> table;
+    std::size_t slot_count;
+    std::size_t mask;
+};
+
+#endif // TRANSPOSITION_TABLE_H